@@ -0,0 +1,80 @@
+/*
+ * This file is part of MIDI2LR. Copyright (C) 2015 by Rory Jaffe.
+ *
+ * MIDI2LR is free software: you can redistribute it and/or modify it under the terms of the GNU
+ * General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * MIDI2LR is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with MIDI2LR.  If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "AllocationCounter.h"
+
+#include <exception>
+#include <mutex>
+#include <utility>
+
+#include "Misc.h"
+
+namespace {
+   std::mutex reports_mutex;
+   std::vector<rsj::AllocationReport> reports;
+} // namespace
+
+void rsj::FileAllocationReport(const AllocationReport& report) noexcept
+{
+   try {
+      auto lock {std::scoped_lock(reports_mutex)};
+      reports.push_back(report);
+   }
+   catch (const std::exception& e) {
+      MIDI2LR_E_RESPONSE_F;
+   }
+}
+
+std::vector<rsj::AllocationReport> rsj::TakeAllocationReports()
+{
+   auto lock {std::scoped_lock(reports_mutex)};
+   return std::exchange(reports, {});
+}
+
+#ifdef MIDI2LR_COUNT_ALLOCATIONS
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace {
+   /* trivially initialized, so using it inside operator new doesn't allocate */
+   thread_local uint64_t thread_allocations {0};
+} // namespace
+
+uint64_t rsj::ThreadAllocations() noexcept { return thread_allocations; }
+
+/* The nothrow and array forms of new and the sized and array forms of delete forward to these by
+ * default, so replacing these two pairs covers them. Aligned allocations aren't counted. */
+void* operator new(std::size_t size)
+{
+   ++thread_allocations;
+   if (size == 0) { size = 1; }
+   for (;;) {
+      // NOLINTNEXTLINE(cppcoreguidelines-no-malloc,hicpp-no-malloc)
+      if (auto* const p {std::malloc(size)}) { return p; }
+      const auto handler {std::get_new_handler()};
+      if (!handler) { throw std::bad_alloc(); }
+      handler();
+   }
+}
+
+// NOLINTNEXTLINE(cppcoreguidelines-no-malloc,hicpp-no-malloc)
+void operator delete(void* p) noexcept { std::free(p); }
+
+// NOLINTNEXTLINE(cppcoreguidelines-no-malloc,hicpp-no-malloc)
+void operator delete(void* p, std::size_t /*size*/) noexcept { std::free(p); }
+#else
+uint64_t rsj::ThreadAllocations() noexcept { return 0; }
+#endif
@@ -0,0 +1,133 @@
+#ifndef MIDI2LR_ALLOCATIONCOUNTER_H_INCLUDED
+#define MIDI2LR_ALLOCATIONCOUNTER_H_INCLUDED
+/*
+ * This file is part of MIDI2LR. Copyright (C) 2015 by Rory Jaffe.
+ *
+ * MIDI2LR is free software: you can redistribute it and/or modify it under the terms of the GNU
+ * General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * MIDI2LR is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with MIDI2LR.  If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <cstdint>
+#include <vector>
+
+/* Define MIDI2LR_COUNT_ALLOCATIONS to replace the global operator new with one that counts
+ * allocations per thread. Each thread on the MIDI path then measures the allocations made for each
+ * event it handles, logs when the steady-state average goes over its budget, and files an
+ * AllocationReport when it stops. The unit tests read those reports to check the budgets. Without
+ * the define the meters do nothing and the counter reads zero. */
+namespace rsj {
+#ifdef MIDI2LR_COUNT_ALLOCATIONS
+   inline constexpr bool kCountAllocations {true};
+#else
+   inline constexpr bool kCountAllocations {false};
+#endif
+
+   /* allocations made by the calling thread so far */
+   [[nodiscard]] uint64_t ThreadAllocations() noexcept;
+
+   /* Allowed average allocations per MIDI event once warmed up. Decoding and dispatch measured 0
+    * per event, so any allocation there is a regression. A device's input thread pushes onto the
+    * lane's std::deque, which allocates a block every few pushes and frees it once drained: 0.008
+    * per event with libstdc++, and up to one every other push with MSVC's small blocks. */
+   inline constexpr uint64_t kDispatchAllocationBudget {0};
+   inline constexpr uint64_t kInputAllocationBudget {1};
+
+   /* steady-state totals of one AllocationMeter, filed when it is destroyed */
+   struct AllocationReport {
+      const char* thread;
+      uint64_t budget;
+      uint64_t events;
+      uint64_t allocations;
+
+      [[nodiscard]] bool OverBudget() const noexcept { return allocations > budget * events; }
+
+      [[nodiscard]] double PerEvent() const noexcept
+      {
+         return events ? static_cast<double>(allocations) / static_cast<double>(events) : 0.0;
+      }
+   };
+
+   void FileAllocationReport(const AllocationReport& report) noexcept;
+   /* reports filed since the last call */
+   [[nodiscard]] std::vector<AllocationReport> TakeAllocationReports();
+
+   /* Measures allocations on one thread across Begin/End pairs. The first kWarmup events are not
+    * counted, so one-time growth of queues and caches isn't mistaken for steady-state cost. */
+   class AllocationMeter {
+    public:
+      static constexpr uint64_t kWarmup {64};
+
+      /* thread names the thread in the report; it must outlive the meter. budget is the allowed
+       * average allocations per event */
+      AllocationMeter(const char* thread, uint64_t budget) noexcept
+          : thread_ {thread}, budget_ {budget}
+      {
+      }
+
+      ~AllocationMeter()
+      {
+         if constexpr (kCountAllocations) {
+            if (events_ > 0) { FileAllocationReport({thread_, budget_, events_, allocations_}); }
+         }
+      }
+
+      AllocationMeter(const AllocationMeter& other) = delete;
+      AllocationMeter(AllocationMeter&& other) = delete;
+      AllocationMeter& operator=(const AllocationMeter& other) = delete;
+      AllocationMeter& operator=(AllocationMeter&& other) = delete;
+
+      void Begin() noexcept
+      {
+         if constexpr (kCountAllocations) { start_ = ThreadAllocations(); }
+      }
+
+      /* returns true the first time the steady-state average exceeds the budget */
+      [[nodiscard]] bool End() noexcept
+      {
+         if constexpr (kCountAllocations) {
+            const auto used {ThreadAllocations() - start_};
+            if (warmup_left_ > 0) {
+               --warmup_left_;
+               return false;
+            }
+            ++events_;
+            allocations_ += used;
+            if (!over_budget_ && events_ >= kWarmup && allocations_ > budget_ * events_) {
+               over_budget_ = true;
+               return true;
+            }
+         }
+         return false;
+      }
+
+      [[nodiscard]] uint64_t Allocations() const noexcept { return allocations_; }
+
+      [[nodiscard]] uint64_t Events() const noexcept { return events_; }
+
+      [[nodiscard]] uint64_t Budget() const noexcept { return budget_; }
+
+      [[nodiscard]] double PerEvent() const noexcept
+      {
+         return AllocationReport {thread_, budget_, events_, allocations_}.PerEvent();
+      }
+
+    private:
+      bool over_budget_ {false};
+      const char* thread_;
+      uint64_t budget_;
+      uint64_t allocations_ {0};
+      uint64_t events_ {0};
+      uint64_t start_ {0};
+      uint64_t warmup_left_ {kWarmup};
+   };
+} // namespace rsj
+
+#endif
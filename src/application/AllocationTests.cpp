@@ -0,0 +1,140 @@
+/*
+ * This file is part of MIDI2LR. Copyright (C) 2015 by Rory Jaffe.
+ *
+ * MIDI2LR is free software: you can redistribute it and/or modify it under the terms of the GNU
+ * General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * MIDI2LR is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with MIDI2LR.  If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifdef MIDI2LR_TESTS
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <tuple>
+#include <utility>
+
+#include <asio/asio.hpp>
+#include <fmt/format.h>
+#include <gsl/gsl>
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_core/juce_core.h>
+
+#include "AllocationCounter.h"
+#include "CommandSet.h"
+#include "ControlsModel.h"
+#include "Devices.h"
+#include "LR_IPC_Out.h"
+#include "MIDIReceiver.h"
+#include "MIDISender.h"
+#include "Profile.h"
+#include "ProfileManager.h"
+#include "UnitTests.h"
+
+namespace {
+   /* counts messages that got through dispatch, so the test knows when the queues have drained */
+   class DispatchCounter {
+    public:
+      void MidiCmdCallback(rsj::MidiMessage /*mm*/)
+      {
+         count_.fetch_add(1, std::memory_order_release);
+      }
+
+      [[nodiscard]] int Count() const noexcept { return count_.load(std::memory_order_acquire); }
+
+    private:
+      std::atomic<int> count_ {0};
+   };
+
+   /* Feeds fader moves through the headless MIDI path: MidiReceiver lane and pipeline, dispatch,
+    * then ProfileManager, ControlsModel and LrIpcOut queueing for Lightroom, with nothing
+    * connected. Each thread's meter files a report when it stops, and every thread has to stay
+    * within its meter's budget: none at all for decoding and dispatch. */
+   class DispatchAllocationTest final : public juce::UnitTest {
+    public:
+      DispatchAllocationTest() : juce::UnitTest {"MIDI dispatch allocations", rsj::kTestCategory}
+      {
+      }
+
+      void runTest() override
+      {
+         beginTest("steady-state allocations per event, each thread");
+         if constexpr (!rsj::kCountAllocations) {
+            logMessage("Built without MIDI2LR_COUNT_ALLOCATIONS, so allocations aren't counted.");
+            return;
+         }
+         std::ignore = rsj::TakeAllocationReports();
+         RunFaders();
+         const auto reports {rsj::TakeAllocationReports()};
+         expect(!reports.empty(), "no thread filed an allocation report");
+         for (const auto& report : reports) {
+            logMessage(fmt::format(FMT_STRING("{}: {} allocations in {} events, {:.2f} per event."),
+                report.thread, report.allocations, report.events, report.PerEvent()));
+            expect(!report.OverBudget(),
+                fmt::format(FMT_STRING("{} is over the budget of {} allocations per event."),
+                    report.thread, report.budget));
+         }
+      }
+
+    private:
+      static constexpr int kEvents {20'000};
+      static constexpr int kBurst {1'000}; /* well under a lane's capacity */
+      static constexpr std::array kCommands {"Exposure", "Contrast", "Highlights", "Shadows",
+          "Whites", "Blacks", "Clarity", "Vibrance"};
+
+      void RunFaders()
+      {
+         asio::io_context io_context;
+         Devices devices;
+         CommandSet command_set;
+         Profile profile {command_set};
+         ControlsModel controls_model;
+         MidiSender midi_sender {devices};
+         MidiReceiver midi_receiver {devices};
+         LrIpcOut lr_ipc_out {command_set, controls_model, profile, midi_sender, midi_receiver,
+             io_context};
+         ProfileManager profile_manager {controls_model, profile, lr_ipc_out, midi_receiver};
+         DispatchCounter counter;
+         midi_receiver.AddCallback(&counter, &DispatchCounter::MidiCmdCallback);
+         for (int i {0}; std::cmp_less(i, kCommands.size()); ++i) {
+            profile.InsertOrAssign(gsl::at(kCommands, i),
+                rsj::MidiMessageId {1, i + 1, rsj::MessageType::kCc});
+         }
+         const auto give_up {std::chrono::steady_clock::now() + std::chrono::seconds(30)};
+         const auto wait_for_dispatch {[&counter, give_up](int count) {
+            while (counter.Count() < count && std::chrono::steady_clock::now() < give_up) {
+               std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            }
+         }};
+         midi_receiver.StartHeadless();
+         {
+            rsj::AllocationMeter feeder {"MIDI input (test thread)", rsj::kInputAllocationBudget};
+            for (int n {0}; n < kEvents; ++n) {
+               /* a lane drops its oldest events when full, so let dispatch catch up between
+                * bursts, as it does with a real device */
+               if (n % kBurst == 0) { wait_for_dispatch(n); }
+               const auto message {juce::MidiMessage::controllerEvent(1,
+                   n % gsl::narrow_cast<int>(kCommands.size()) + 1, n / 8 % 128)};
+               feeder.Begin();
+               midi_receiver.Feed(message);
+               std::ignore = feeder.End();
+            }
+         }
+         wait_for_dispatch(kEvents);
+         expectEquals(counter.Count(), kEvents, "not all events were dispatched");
+         midi_receiver.Stop();
+         lr_ipc_out.Stop();
+      } /* threads are joined and their meters file reports as the objects go */
+   };
+
+   DispatchAllocationTest dispatch_allocation_test; /* registers itself with juce::UnitTest */
+} // namespace
+#endif
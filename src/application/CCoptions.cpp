@@ -153,7 +153,7 @@ CCoptions::CCoptions()
    applyAll.reset(new TextButton("new button"));
    addAndMakeVisible(applyAll.get());
    applyAll->setTooltip(TRANS("Apply these settings to all similar controls."));
-   applyAll->setExplicitFocusOrder(7);
+   applyAll->setExplicitFocusOrder(9);
    applyAll->setButtonText(TRANS("Apply to all"));
    applyAll->addListener(this);
 
@@ -165,16 +165,70 @@ CCoptions::CCoptions()
    controlID->setColour(TextEditor::textColourId, Colours::black);
    controlID->setColour(TextEditor::backgroundColourId, Colour(0x00000000));
 
+   curvelabel.reset(new Label("curvelabel", TRANS("Response curve")));
+   addAndMakeVisible(curvelabel.get());
+   curvelabel->setFont(Font(15.00f, Font::plain).withTypefaceStyle("Regular"));
+   curvelabel->setJustificationType(Justification::centredLeft);
+   curvelabel->setEditable(false, false, false);
+   curvelabel->setColour(TextEditor::textColourId, Colours::black);
+   curvelabel->setColour(TextEditor::backgroundColourId, Colour(0x00000000));
+
+   curvelabel->setBounds(16, 308, 120, 24);
+
+   curvebox.reset(new ComboBox("curvebox"));
+   addAndMakeVisible(curvebox.get());
+   curvebox->setTooltip(TRANS("How the value sent to Lightroom follows the control between the "
+                              "minimum and maximum values."));
+   curvebox->setExplicitFocusOrder(7);
+   curvebox->setEditableText(false);
+   curvebox->setJustificationType(Justification::centredLeft);
+   curvebox->setTextWhenNothingSelected(String());
+   curvebox->setTextWhenNoChoicesAvailable(TRANS("(no choices)"));
+   curvebox->addItem(TRANS("Linear"), 1);
+   curvebox->addItem(TRANS("Exponential"), 2);
+   curvebox->addItem(TRANS("S-curve"), 3);
+   curvebox->addItem(TRANS("Points"), 4);
+   curvebox->addListener(this);
+
+   curvebox->setBounds(136, 308, 120, 24);
+
+   curvetextlabel.reset(new Label("curvetextlabel", TRANS("Amount")));
+   addAndMakeVisible(curvetextlabel.get());
+   curvetextlabel->setFont(Font(15.00f, Font::plain).withTypefaceStyle("Regular"));
+   curvetextlabel->setJustificationType(Justification::centredLeft);
+   curvetextlabel->setEditable(false, false, false);
+   curvetextlabel->setColour(TextEditor::textColourId, Colours::black);
+   curvetextlabel->setColour(TextEditor::backgroundColourId, Colour(0x00000000));
+
+   curvetextlabel->setBounds(16, 348, 72, 24);
+
+   curvetext.reset(new TextEditor("curvetext"));
+   addAndMakeVisible(curvetext.get());
+   curvetext->setExplicitFocusOrder(8);
+   curvetext->setMultiLine(false);
+   curvetext->setReturnKeyStartsNewLine(false);
+   curvetext->setReadOnly(false);
+   curvetext->setScrollbarsShown(true);
+   curvetext->setCaretVisible(true);
+   curvetext->setPopupMenuEnabled(true);
+   curvetext->setText(String());
+
+   curvetext->setBounds(96, 348, 160, 24);
+
    //[UserPreSize]
    //[/UserPreSize]
 
-   setSize(280, 350);
+   setSize(280, 430);
 
    //[Constructor] You can add your own custom stuff here..
    maxvaltext->setInputFilter(&numrestrict_, false);
    minvaltext->setInputFilter(&numrestrict_, false);
    maxvaltext->addListener(this);
    minvaltext->addListener(this);
+   curvetext->setInputFilter(&curverestrict_, false);
+   curvetext->addListener(this);
+   curvebox->setSelectedId(1, dontSendNotification);
+   ShowCurveEditor();
    //[/Constructor]
 }
 
@@ -194,6 +248,10 @@ CCoptions::~CCoptions()
    maxvallabel = nullptr;
    applyAll = nullptr;
    controlID = nullptr;
+   curvelabel = nullptr;
+   curvebox = nullptr;
+   curvetextlabel = nullptr;
+   curvetext = nullptr;
 
    //[Destructor]. You can add your own custom destruction code here..
    //[/Destructor]
@@ -216,7 +274,7 @@ void CCoptions::resized()
    //[UserPreResize] Add your own custom resize code here..
    //[/UserPreResize]
 
-   applyAll->setBounds((getWidth() / 2) - (150 / 2), (getHeight() / 2) + 141, 150, 24);
+   applyAll->setBounds((getWidth() / 2) - (150 / 2), (getHeight() / 2) + 177, 150, 24);
    controlID->setBounds((getWidth() / 2) - (248 / 2), 16, 248, 24);
    //[UserResized] Add your own custom resize handling here..
    //[/UserResized]
@@ -234,6 +292,7 @@ void CCoptions::buttonClicked(Button* buttonThatWasClicked)
       maxvallabel->setText(TRANS("Resolution"), juce::dontSendNotification);
       minvaltext->setText("0", juce::dontSendNotification);
       controls_model_->SetCcMethod(bound_channel_, bound_number_, rsj::CCmethod::kTwosComplement);
+      ShowCurveEditor();
       //[/UserButtonCode_twosbutton]
    }
    else if (buttonThatWasClicked == absbutton.get()) {
@@ -242,6 +301,7 @@ void CCoptions::buttonClicked(Button* buttonThatWasClicked)
       minvallabel->setVisible(true);
       maxvallabel->setText(TRANS("Maximum value"), juce::dontSendNotification);
       controls_model_->SetCcMethod(bound_channel_, bound_number_, rsj::CCmethod::kAbsolute);
+      ShowCurveEditor();
       //[/UserButtonCode_absbutton]
    }
    else if (buttonThatWasClicked == binbutton.get()) {
@@ -251,6 +311,7 @@ void CCoptions::buttonClicked(Button* buttonThatWasClicked)
       maxvallabel->setText(TRANS("Resolution"), juce::dontSendNotification);
       minvaltext->setText("0", juce::dontSendNotification);
       controls_model_->SetCcMethod(bound_channel_, bound_number_, rsj::CCmethod::kBinaryOffset);
+      ShowCurveEditor();
 
       //[/UserButtonCode_binbutton]
    }
@@ -261,6 +322,7 @@ void CCoptions::buttonClicked(Button* buttonThatWasClicked)
       maxvallabel->setText(TRANS("Resolution"), juce::dontSendNotification);
       minvaltext->setText("0", juce::dontSendNotification);
       controls_model_->SetCcMethod(bound_channel_, bound_number_, rsj::CCmethod::kSignMagnitude);
+      ShowCurveEditor();
       //[/UserButtonCode_signbutton]
    }
    else if (buttonThatWasClicked == applyAll.get()) {
@@ -280,7 +342,7 @@ void CCoptions::buttonClicked(Button* buttonThatWasClicked)
          throw std::logic_error("CCoptions::buttonClicked reached unreachable code");
       }
       controls_model_->SetCcAll(bound_channel_, bound_number_, minvaltext->getText().getIntValue(),
-          maxvaltext->getText().getIntValue(), ccm);
+          maxvaltext->getText().getIntValue(), ccm, CurveFromEditors());
       //[/UserButtonCode_applyAll]
    }
    else { /* no action needed */
@@ -290,6 +352,36 @@ void CCoptions::buttonClicked(Button* buttonThatWasClicked)
    //[/UserbuttonClicked_Post]
 }
 
+void CCoptions::comboBoxChanged(ComboBox* comboBoxThatHasChanged)
+{
+   //[UsercomboBoxChanged_Pre]
+   //[/UsercomboBoxChanged_Pre]
+
+   if (comboBoxThatHasChanged == curvebox.get()) {
+      //[UserComboBoxCode_curvebox] -- add your combo box handling code here..
+      switch (static_cast<rsj::CCcurve>(curvebox->getSelectedId() - 1)) {
+      case rsj::CCcurve::kLinear:
+         curvetext->setText(String(), dontSendNotification);
+         break;
+      case rsj::CCcurve::kExponential:
+         curvetext->setText("3", dontSendNotification);
+         break;
+      case rsj::CCcurve::kSCurve:
+         curvetext->setText("2", dontSendNotification);
+         break;
+      case rsj::CCcurve::kPoints:
+         curvetext->setText("0.3:0.45 0.7:0.55", dontSendNotification);
+         break;
+      }
+      ShowCurveEditor();
+      controls_model_->SetCcCurve(bound_channel_, bound_number_, CurveFromEditors());
+      //[/UserComboBoxCode_curvebox]
+   }
+
+   //[UsercomboBoxChanged_Post]
+   //[/UsercomboBoxChanged_Post]
+}
+
 //[MiscUserCode] You can add your own definitions of your custom methods or any other code here...
 void CCoptions::textEditorFocusLost(TextEditor& t)
 {
@@ -299,6 +391,9 @@ void CCoptions::textEditorFocusLost(TextEditor& t)
    else if (nam == "maxvaltext") {
       controls_model_->SetCcMax(bound_channel_, bound_number_, val);
    }
+   else if (nam == "curvetext") {
+      controls_model_->SetCcCurve(bound_channel_, bound_number_, CurveFromEditors());
+   }
    else { /* no action needed */
    }
 }
@@ -314,6 +409,12 @@ void CCoptions::BindToControl(const int channel, const int control_number)
        juce::dontSendNotification);
    maxvaltext->setText(juce::String(controls_model_->GetCcMax(bound_channel_, bound_number_)),
        juce::dontSendNotification);
+   const auto curve {controls_model_->GetCcCurve(bound_channel_, bound_number_)};
+   curvebox->setSelectedId(static_cast<int>(curve.shape) + 1, juce::dontSendNotification);
+   curvetext->setText(curve.shape == rsj::CCcurve::kPoints ? juce::String(curve.points)
+                      : curve.shape == rsj::CCcurve::kLinear ? juce::String()
+                                                             : juce::String(curve.amount),
+       juce::dontSendNotification);
    switch (controls_model_->GetCcMethod(bound_channel_, bound_number_)) {
    case rsj::CCmethod::kAbsolute:
       absbutton->setToggleState(true, juce::sendNotification);
@@ -328,6 +429,45 @@ void CCoptions::BindToControl(const int channel, const int control_number)
       twosbutton->setToggleState(true, juce::sendNotification);
       break;
    }
+   ShowCurveEditor();
+}
+
+rsj::CurveSpec CCoptions::CurveFromEditors() const
+{
+   rsj::CurveSpec curve {};
+   const auto id {curvebox->getSelectedId()};
+   if (id < 1 || id > 4) { return curve; }
+   curve.shape = static_cast<rsj::CCcurve>(id - 1);
+   if (curve.shape == rsj::CCcurve::kPoints) { curve.points = curvetext->getText().toStdString(); }
+   else if (curve.shape != rsj::CCcurve::kLinear) {
+      curve.amount = rsj::ClampCurveAmount(curvetext->getText().getDoubleValue());
+   }
+   return curve;
+}
+
+/* curves apply to absolute controls only; the text is the amount, or the points */
+void CCoptions::ShowCurveEditor()
+{
+   const auto absolute {absbutton->getToggleState()};
+   const auto shape {static_cast<rsj::CCcurve>(curvebox->getSelectedId() - 1)};
+   curvelabel->setVisible(absolute);
+   curvebox->setVisible(absolute);
+   curvetextlabel->setVisible(absolute && shape != rsj::CCcurve::kLinear);
+   curvetext->setVisible(absolute && shape != rsj::CCcurve::kLinear);
+   if (shape == rsj::CCcurve::kPoints) {
+      curvetextlabel->setText(TRANS("Points"), juce::dontSendNotification);
+      curvetext->setTooltip(TRANS("Pairs of control position:value sent to Lightroom, each from 0 "
+                                  "to 1, separated by spaces. The ends are 0:0 and 1:1 unless "
+                                  "given."));
+   }
+   else {
+      curvetextlabel->setText(TRANS("Amount"), juce::dontSendNotification);
+      curvetext->setTooltip(shape == rsj::CCcurve::kSCurve
+                                ? TRANS("Above 1 gives finer control near the center, below 1 "
+                                        "finer control near the ends.")
+                                : TRANS("Above 0 gives finer control near the minimum, below 0 "
+                                        "finer control near the maximum."));
+   }
 }
 //[/MiscUserCode]
 
@@ -341,10 +481,10 @@ void CCoptions::BindToControl(const int channel, const int control_number)
 BEGIN_JUCER_METADATA
 
 <JUCER_COMPONENT documentType="Component" className="CCoptions" componentName=""
-                 parentClasses="public Component, private TextEditor::Listener"
+                 parentClasses="public Component, private TextEditor::Listener, public ComboBox::Listener"
                  constructorParams="" variableInitialisers="" snapPixels="8" snapActive="1"
                  snapShown="1" overlayOpacity="0.330" fixedSize="1" initialWidth="280"
-                 initialHeight="350">
+                 initialHeight="430">
   <BACKGROUND backgroundColour="ffffffff"/>
   <GROUPCOMPONENT name="CCmethod" id="3dee10ca9db3e476" memberName="groupComponent"
                   virtualName="" explicitFocusOrder="0" pos="16 60 240 157" title="CC Message Type"/>
@@ -383,7 +523,7 @@ BEGIN_JUCER_METADATA
          editableDoubleClick="0" focusDiscardsChanges="0" fontname="Default font"
          fontsize="15.0" kerning="0.0" bold="0" italic="0" justification="33"/>
   <TEXTBUTTON name="new button" id="836af06f251dc94d" memberName="applyAll"
-              virtualName="" explicitFocusOrder="7" pos="0Cc 141C 150 24" tooltip="Apply these settings to all similar controls."
+              virtualName="" explicitFocusOrder="9" pos="0Cc 177C 150 24" tooltip="Apply these settings to all similar controls."
               buttonText="Apply to all" connectedEdges="0" needsCallback="1"
               radioGroupId="0"/>
   <LABEL name="channel 0 number 0" id="aa2312920c3b6ed" memberName="controlID"
@@ -391,6 +531,24 @@ BEGIN_JUCER_METADATA
          edBkgCol="0" labelText="Channel 0 Number 0" editableSingleClick="0"
          editableDoubleClick="0" focusDiscardsChanges="0" fontname="Default font"
          fontsize="15.0" kerning="0.0" bold="0" italic="0" justification="36"/>
+  <LABEL name="curvelabel" id="4b1f0e7c9a2d6e31" memberName="curvelabel"
+         virtualName="" explicitFocusOrder="0" pos="16 308 120 24" edTextCol="ff000000"
+         edBkgCol="0" labelText="Response curve" editableSingleClick="0"
+         editableDoubleClick="0" focusDiscardsChanges="0" fontname="Default font"
+         fontsize="15.0" kerning="0.0" bold="0" italic="0" justification="33"/>
+  <COMBOBOX name="curvebox" id="c83a5d2e71f04b96" memberName="curvebox"
+            virtualName="" explicitFocusOrder="7" pos="136 308 120 24" tooltip="How the value sent to Lightroom follows the control between the minimum and maximum values."
+            editable="0" layout="33" items="Linear&#10;Exponential&#10;S-curve&#10;Points"
+            textWhenNonSelected="" textWhenNoItems="(no choices)"/>
+  <LABEL name="curvetextlabel" id="9e60d4b2a17c3f58" memberName="curvetextlabel"
+         virtualName="" explicitFocusOrder="0" pos="16 348 72 24" edTextCol="ff000000"
+         edBkgCol="0" labelText="Amount" editableSingleClick="0" editableDoubleClick="0"
+         focusDiscardsChanges="0" fontname="Default font" fontsize="15.0"
+         kerning="0.0" bold="0" italic="0" justification="33"/>
+  <TEXTEDITOR name="curvetext" id="5da7e2c4f90b1836" memberName="curvetext"
+              virtualName="" explicitFocusOrder="8" pos="96 348 160 24" initialText=""
+              multiline="0" retKeyStartsLine="0" readonly="0" scrollbars="1"
+              caret="1" popupmenu="1"/>
 </JUCER_COMPONENT>
 
 END_JUCER_METADATA
@@ -38,6 +38,9 @@
 #pragma once
 #include "../JuceLibraryCode/JuceHeader.h"
 class ControlsModel;
+namespace rsj {
+   struct CurveSpec;
+}
 #ifndef _MSC_VER
 #define _In_ //-V3547
 #endif
@@ -54,7 +57,8 @@ class ControlsModel;
 */
 class CCoptions  : public juce::Component,
                    private juce::TextEditor::Listener,
-                   public juce::Button::Listener
+                   public juce::Button::Listener,
+                   public juce::ComboBox::Listener
 {
 public:
     //==============================================================================
@@ -75,13 +79,17 @@ class CCoptions  : public juce::Component,
     void paint (juce::Graphics& g) override;
     void resized() override;
     void buttonClicked (juce::Button* buttonThatWasClicked) override;
+    void comboBoxChanged (juce::ComboBox* comboBoxThatHasChanged) override;
 
 
 
 private:
     //[UserVariables]   -- You can add your own custom variables in this section.
    juce::TextEditor::LengthAndCharacterRestriction numrestrict_{5, "0123456789"};
+   juce::TextEditor::LengthAndCharacterRestriction curverestrict_{200, "0123456789.-: "};
    void textEditorFocusLost(juce::TextEditor& t) override;
+   [[nodiscard]] rsj::CurveSpec CurveFromEditors() const;
+   void ShowCurveEditor();
    inline static ControlsModel* controls_model_{nullptr};
    int bound_channel_{0}; // note: 0-based in program, add one to compensate for display
    int bound_number_{0};
@@ -99,6 +107,10 @@ class CCoptions  : public juce::Component,
     std::unique_ptr<juce::Label> maxvallabel;
     std::unique_ptr<juce::TextButton> applyAll;
     std::unique_ptr<juce::Label> controlID;
+    std::unique_ptr<juce::Label> curvelabel;
+    std::unique_ptr<juce::ComboBox> curvebox;
+    std::unique_ptr<juce::Label> curvetextlabel;
+    std::unique_ptr<juce::TextEditor> curvetext;
 
 
     //==============================================================================
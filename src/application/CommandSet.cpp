@@ -24,6 +24,7 @@
 #include <cereal/archives/xml.hpp>
 #include <cereal/types/string.hpp> /*ReSharper false alarm*/
 #include <cereal/types/unordered_map.hpp>
+#include <cereal/types/unordered_set.hpp>
 #include <cereal/types/vector.hpp> /*ReSharper false alarm*/
 
 #include "Translate.h"
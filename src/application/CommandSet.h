@@ -17,6 +17,7 @@
  */
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -44,6 +45,9 @@ class CommandSet {
 
    [[nodiscard]] auto CommandLabelAt(size_t index) const { return cmd_label_by_number_.at(index); }
 
+   /* commands the plugin runs as actions rather than setting a value */
+   [[nodiscard]] const auto& GetButtons() const noexcept { return m_impl_.buttons_; }
+
    [[nodiscard]] const auto& GetLanguage() const noexcept { return m_impl_.language_; }
 
    [[nodiscard]] const auto& GetMenus() const noexcept { return menus_; }
@@ -75,7 +79,13 @@ class CommandSet {
       template<class Archive> void serialize(Archive& archive, std::uint32_t const version)
       {
          try {
-            if (std::cmp_equal(version, 2)) {
+            if (std::cmp_equal(version, 3)) {
+               archive(cereal::make_nvp("language", language_),
+                   cereal::make_nvp("all_commands", allcommands_),
+                   cereal::make_nvp("repeats", repeat_messages_),
+                   cereal::make_nvp("wraps", wraps_), cereal::make_nvp("buttons", buttons_));
+            }
+            else if (std::cmp_equal(version, 2)) { /* no buttons: all values are continuous */
                archive(cereal::make_nvp("language", language_),
                    cereal::make_nvp("all_commands", allcommands_),
                    cereal::make_nvp("repeats", repeat_messages_),
@@ -100,6 +110,7 @@ class CommandSet {
           allcommands_;
       std::unordered_map<std::string, std::pair<std::string, std::string>> repeat_messages_;
       std::vector<std::string> wraps_;
+      std::unordered_set<std::string> buttons_;
    };
 
    friend class cereal::access;
@@ -116,6 +127,6 @@ class CommandSet {
 
 #pragma warning(push)
 #pragma warning(disable : 26426 26440 26444)
-CEREAL_CLASS_VERSION(CommandSet::Impl, 2)
+CEREAL_CLASS_VERSION(CommandSet::Impl, 3)
 #pragma warning(pop)
 #endif
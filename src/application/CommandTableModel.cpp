@@ -18,6 +18,7 @@
 #include <algorithm>
 #include <exception>
 #include <memory>
+#include <string>
 #include <utility>
 
 #include <fmt/format.h>
@@ -26,11 +27,72 @@
 #include "CommandMenu.h"
 #include "Misc.h"
 
+namespace {
+   juce::String FormatMessage(const rsj::MidiMessageId& cmd)
+   {
+      std::string format_str;
+      switch (cmd.msg_id_type) {
+      case rsj::MessageType::kNoteOn:
+         format_str = fmt::format(FMT_STRING("{} | Note : {}"), cmd.channel, cmd.control_number);
+         break;
+      case rsj::MessageType::kNoteOff:
+         format_str =
+             fmt::format(FMT_STRING("{} | Note Off: {}"), cmd.channel, cmd.control_number);
+         break;
+      case rsj::MessageType::kCc:
+         if (rsj::IsCc14Bit(cmd.control_number)) {
+            format_str = fmt::format(FMT_STRING("{} | CC14: {}"), cmd.channel,
+                cmd.control_number - rsj::kCc14BitBase);
+         }
+         else {
+            format_str = fmt::format(FMT_STRING("{} | CC: {}"), cmd.channel, cmd.control_number);
+         }
+         break;
+      case rsj::MessageType::kPw:
+         format_str = fmt::format(FMT_STRING("{} | Pitch Bend"), cmd.channel);
+         break;
+      case rsj::MessageType::kKeyPressure:
+         format_str =
+             fmt::format(FMT_STRING("{} | Key Pressure: {}"), cmd.channel, cmd.control_number);
+         break;
+      case rsj::MessageType::kChanPressure:
+         format_str = fmt::format(FMT_STRING("{} | Channel Pressure"), cmd.channel);
+         break;
+      case rsj::MessageType::kPgmChange:
+         format_str = fmt::format(FMT_STRING("{} | Program Change"), cmd.channel);
+         break;
+      case rsj::MessageType::kSystem:
+         break;
+      }
+      return juce::String {format_str};
+   }
+} // namespace
+
 CommandTableModel::CommandTableModel(const CommandSet& command_set, Profile& profile) noexcept
     : command_set_ {command_set}, profile_ {profile}
 {
 }
 
+const std::vector<CommandTableModel::Row>& CommandTableModel::Rows()
+{
+   try {
+      if (profile_.Version() != rows_version_) {
+         auto [version, table] {profile_.Snapshot()};
+         rows_.clear();
+         rows_.reserve(table.size());
+         for (const auto& [id, command] : table) {
+            rows_.push_back({id, FormatMessage(id), command_set_.CommandTextIndex(command)});
+         }
+         rows_version_ = version;
+      }
+      return rows_;
+   }
+   catch (const std::exception& e) {
+      MIDI2LR_E_RESPONSE;
+      throw;
+   }
+}
+
 void CommandTableModel::paintCell(juce::Graphics& g, int row_number, const int column_id,
     const int width, const int height, bool /*rowIsSelected*/)
 {
@@ -43,46 +105,17 @@ void CommandTableModel::paintCell(juce::Graphics& g, int row_number, const int c
       g.setFont(std::min(16.0F, static_cast<float>(height) * 0.7F));
       if (column_id == 1) {
          /* write the MIDI message in the MIDI command column */
-         if (std::cmp_less_equal(profile_.Size(), row_number)) [[unlikely]] {
+         const auto& rows {Rows()};
+         if (row_number < 0 || std::cmp_less_equal(rows.size(), row_number)) [[unlikely]] {
             /* error condition */
             g.drawText("Unknown control", 0, 0, width, height, juce::Justification::centred);
             rsj::Log(fmt::format(FMT_STRING("Unknown control CommandTableModel::paintCell. {} rows "
                                             "in profile, row number to be painted is {}."),
-                profile_.Size(), row_number));
+                rows.size(), row_number));
          }
          else {
-            std::string format_str;
-            switch (const auto cmd {
-                profile_.GetMessageForNumber(gsl::narrow_cast<size_t>(row_number))};
-                    cmd.msg_id_type) {
-            case rsj::MessageType::kNoteOn:
-               format_str =
-                   fmt::format(FMT_STRING("{} | Note : {}"), cmd.channel, cmd.control_number);
-               break;
-            case rsj::MessageType::kNoteOff:
-               format_str =
-                   fmt::format(FMT_STRING("{} | Note Off: {}"), cmd.channel, cmd.control_number);
-               break;
-            case rsj::MessageType::kCc:
-               format_str = fmt::format(FMT_STRING("{} | CC: {}"), cmd.channel, cmd.control_number);
-               break;
-            case rsj::MessageType::kPw:
-               format_str = fmt::format(FMT_STRING("{} | Pitch Bend"), cmd.channel);
-               break;
-            case rsj::MessageType::kKeyPressure:
-               format_str = fmt::format(FMT_STRING("{} | Key Pressure: {}"), cmd.channel,
-                   cmd.control_number);
-               break;
-            case rsj::MessageType::kChanPressure:
-               format_str = fmt::format(FMT_STRING("{} | Channel Pressure"), cmd.channel);
-               break;
-            case rsj::MessageType::kPgmChange:
-               format_str = fmt::format(FMT_STRING("{} | Program Change"), cmd.channel);
-               break;
-            case rsj::MessageType::kSystem:
-               break;
-            }
-            g.drawText(format_str, 0, 0, width, height, juce::Justification::centredLeft);
+            g.drawText(rows[gsl::narrow_cast<size_t>(row_number)].label, 0, 0, width, height,
+                juce::Justification::centredLeft);
          }
       }
    }
@@ -127,25 +160,23 @@ juce::Component* CommandTableModel::refreshComponentForCell(int row_number, cons
    try {
       if (column_id == 2) /* LR command column */
       {
+         const auto& rows {Rows()};
+         if (row_number < 0 || std::cmp_less_equal(rows.size(), row_number)) [[unlikely]] {
+            delete existing_component; // NOLINT(cppcoreguidelines-owning-memory)
+            return nullptr;
+         }
+         const auto& row {rows[gsl::narrow_cast<size_t>(row_number)]};
          const auto command_select {dynamic_cast<CommandMenu*>(existing_component)};
          if (command_select == nullptr) {
             /* create a new command menu, delete old one if it exists */
             delete existing_component; // NOLINT(cppcoreguidelines-owning-memory)
-            auto new_select {std::make_unique<CommandMenu>(
-                profile_.GetMessageForNumber(gsl::narrow_cast<size_t>(row_number)), command_set_,
-                profile_)};
-            new_select->SetSelectedItem(
-                command_set_.CommandTextIndex(profile_.GetCommandForMessage(
-                    profile_.GetMessageForNumber(gsl::narrow_cast<size_t>(row_number))))
-                + 1);
+            auto new_select {std::make_unique<CommandMenu>(row.id, command_set_, profile_)};
+            new_select->SetSelectedItem(row.command_index + 1);
             return new_select.release();
          }
          /* change old command menu */
-         command_select->SetMsg(profile_.GetMessageForNumber(gsl::narrow_cast<size_t>(row_number)));
-         command_select->SetSelectedItem(
-             command_set_.CommandTextIndex(profile_.GetCommandForMessage(
-                 profile_.GetMessageForNumber(gsl::narrow_cast<size_t>(row_number))))
-             + 1);
+         command_select->SetMsg(row.id);
+         command_select->SetSelectedItem(row.command_index + 1);
          return command_select;
       }
       return nullptr;
@@ -16,6 +16,9 @@
  *
  */
 
+#include <cstdint>
+#include <vector>
+
 #include <juce_graphics/juce_graphics.h>
 #include <juce_gui_basics/juce_gui_basics.h>
 
@@ -34,7 +37,16 @@ class CommandTableModel final : public juce::TableListBoxModel {
    }
 
  private:
-   [[nodiscard]] int getNumRows() override { return gsl::narrow_cast<int>(profile_.Size()); }
+   /* one pre-formatted table row, taken from a Profile snapshot */
+   struct Row {
+      rsj::MidiMessageId id;
+      juce::String label;
+      size_t command_index;
+   };
+
+   /* rebuilds the cached rows if Profile has changed since they were taken */
+   [[nodiscard]] const std::vector<Row>& Rows();
+   [[nodiscard]] int getNumRows() override { return gsl::narrow_cast<int>(Rows().size()); }
 
    void paintCell(juce::Graphics&, int row_number, int column_id, int width, int height,
        bool row_is_selected) override;
@@ -46,5 +58,7 @@ class CommandTableModel final : public juce::TableListBoxModel {
 
    const CommandSet& command_set_;
    Profile& profile_;
+   std::vector<Row> rows_ {};
+   uint64_t rows_version_ {UINT64_MAX};
 };
 #endif
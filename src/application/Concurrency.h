@@ -15,15 +15,23 @@
  * see <http://www.gnu.org/licenses/>.
  *
  */
+#include <chrono>
 #include <condition_variable>
 #include <deque>
 #include <mutex>
 #include <optional>
+#include <ranges>
 #include <type_traits>
 #include <utility>
 
 namespace rsj {
-   /* all but blocking pops use scoped_lock. blocking pops use unique_lock */
+   /* what a push does when a bounded queue is full */
+   enum class Overflow : char { kBlock, kDropOldest, kReject };
+
+   /* operations that may wait (pops, and pushes to a full queue with Overflow::kBlock) use
+    * unique_lock, the rest use scoped_lock. A queue is unbounded unless set_capacity is called.
+    * close() ends it: pushes are rejected and waiting pops wake, drain what is left, then report
+    * the queue closed, so consumers don't need a sentinel value to stop */
    template<typename T, class Container = std::deque<T>, class Mutex = std::mutex>
    class ConcurrentQueue {
     public:
@@ -149,52 +157,172 @@ namespace rsj {
          return queue_.max_size();
       }
 
-      void push(const T& value)
+      /* pushes return false if the value wasn't added: the queue is closed, or full with
+       * Overflow::kReject */
+      bool push(const T& value)
       {
          {
-            auto lock {std::scoped_lock(mutex_)};
+            auto lock {std::unique_lock(mutex_)};
+            if (!MakeRoomI(lock)) { return false; }
             queue_.push_back(value);
          }
          condition_.notify_one();
+         return true;
       }
 
-      void push(T&& value)
+      bool push(T&& value)
       {
          {
-            auto lock {std::scoped_lock(mutex_)};
+            auto lock {std::unique_lock(mutex_)};
+            if (!MakeRoomI(lock)) { return false; }
             queue_.push_back(std::move(value));
          }
          condition_.notify_one();
+         return true;
+      }
+
+      /* appends all of range under one lock and wakes waiting consumers once. Returns the number
+       * added */
+      template<std::ranges::input_range R> size_type push_range(R&& range)
+      {
+         size_type added {0};
+         {
+            auto lock {std::unique_lock(mutex_)};
+            for (auto& value : range) {
+               if (!MakeRoomI(lock)) { break; }
+               if constexpr (std::is_rvalue_reference_v<R&&>) {
+                  queue_.push_back(std::move(value));
+               }
+               else {
+                  queue_.push_back(value);
+               }
+               ++added;
+            }
+         }
+         condition_.notify_all();
+         return added;
       }
 
-      template<class... Args> void emplace(Args&&... args)
+      template<class... Args> bool emplace(Args&&... args)
       {
          {
             T new_item {std::forward<Args>(args)...};
-            auto lock {std::scoped_lock(mutex_)};
+            auto lock {std::unique_lock(mutex_)};
+            if (!MakeRoomI(lock)) { return false; }
             queue_.push_back(std::move(new_item));
          }
          condition_.notify_one();
+         return true;
       }
 
-      T pop()
+      std::optional<T> try_pop()
       {
          auto lock {std::unique_lock(mutex_)};
-         while (queue_.empty()) { condition_.wait(lock); }
+         if (queue_.empty()) { return std::nullopt; }
          T rc {std::move(queue_.front())};
          queue_.pop_front();
+         NotifyNotFullI(lock);
          return rc;
       }
 
-      std::optional<T> try_pop()
+      /* nullopt on timeout, or if closed and drained */
+      template<class Clock, class Duration>
+      std::optional<T> try_pop_until(const std::chrono::time_point<Clock, Duration>& timeout_time)
       {
-         auto lock {std::scoped_lock(mutex_)};
-         if (queue_.empty()) { return std::nullopt; }
+         auto lock {std::unique_lock(mutex_)};
+         if (!condition_.wait_until(lock, timeout_time,
+                 [this] { return !queue_.empty() || closed_; })
+             || queue_.empty()) {
+            return std::nullopt;
+         }
          T rc {std::move(queue_.front())};
          queue_.pop_front();
+         NotifyNotFullI(lock);
          return rc;
       }
 
+      template<class Rep, class Period>
+      std::optional<T> try_pop_for(const std::chrono::duration<Rep, Period>& rel_time)
+      {
+         return try_pop_until(std::chrono::steady_clock::now() + rel_time);
+      }
+
+      /* Waits for at least one item, then swaps all of them into buffer under one lock. buffer
+       * should be empty: pass the same one each time, cleared, and the storage of the two
+       * containers is reused. Returns false once the queue is closed and drained */
+      bool pop_all(Container& buffer)
+      {
+         auto lock {std::unique_lock(mutex_)};
+         condition_.wait(lock, [this] { return !queue_.empty() || closed_; });
+         if (queue_.empty()) { return false; }
+         queue_.swap(buffer);
+         NotifyNotFullI(lock);
+         return true;
+      }
+
+      /* as pop_all, but returns true with buffer unchanged if nothing arrives by timeout_time */
+      template<class Clock, class Duration>
+      bool pop_all_until(Container& buffer,
+          const std::chrono::time_point<Clock, Duration>& timeout_time)
+      {
+         auto lock {std::unique_lock(mutex_)};
+         if (!condition_.wait_until(lock, timeout_time,
+                 [this] { return !queue_.empty() || closed_; })) {
+            return true;
+         }
+         if (queue_.empty()) { return false; }
+         queue_.swap(buffer);
+         NotifyNotFullI(lock);
+         return true;
+      }
+
+      template<class Rep, class Period>
+      bool pop_all_for(Container& buffer, const std::chrono::duration<Rep, Period>& rel_time)
+      {
+         return pop_all_until(buffer, std::chrono::steady_clock::now() + rel_time);
+      }
+
+      /* Doesn't wait: moves up to max items, oldest first, to the back of buffer under one lock.
+       * Returns the number moved. With a buffer reserved to max, this doesn't allocate */
+      template<class Buffer> size_type pop_some(Buffer& buffer, size_type max)
+      {
+         auto lock {std::unique_lock(mutex_)};
+         size_type count {0};
+         for (; count < max && !queue_.empty(); ++count) {
+            buffer.push_back(std::move(queue_.front()));
+            queue_.pop_front();
+         }
+         if (count != 0) { NotifyNotFullI(lock); }
+         return count;
+      }
+
+      /* 0, the default, is unbounded. Items already queued beyond a new capacity are kept */
+      void set_capacity(size_type capacity, Overflow overflow = Overflow::kBlock)
+      {
+         {
+            auto lock {std::scoped_lock(mutex_)};
+            capacity_ = capacity;
+            overflow_ = overflow;
+         }
+         not_full_.notify_all();
+      }
+
+      void close()
+      {
+         {
+            auto lock {std::scoped_lock(mutex_)};
+            closed_ = true;
+         }
+         condition_.notify_all();
+         not_full_.notify_all();
+      }
+
+      [[nodiscard]] bool closed() const
+      {
+         auto lock {std::scoped_lock(mutex_)};
+         return closed_;
+      }
+
       void swap(ConcurrentQueue& other) noexcept(
           std::is_nothrow_swappable_v<Container>&& noexcept(std::scoped_lock(mutex_)))
       {
@@ -226,8 +354,11 @@ namespace rsj {
                   std::is_nothrow_swappable_v<Container>&& noexcept(std::scoped_lock(mutex_)))
       { /*https://devblogs.microsoft.com/oldnewthing/20201112-00/?p=104444 */
          Container trash {};
-         auto lock {std::scoped_lock(mutex_)};
-         std::swap(trash, queue_);
+         {
+            auto lock {std::scoped_lock(mutex_)};
+            std::swap(trash, queue_);
+         }
+         not_full_.notify_all();
       }
 
       [[nodiscard]] size_type clear_count() noexcept(
@@ -240,6 +371,7 @@ namespace rsj {
             auto lock {std::scoped_lock(mutex_)};
             std::swap(trash, queue_);
          }
+         not_full_.notify_all();
          return trash.size();
       }
 
@@ -281,10 +413,45 @@ namespace rsj {
       }
 
     private:
+      using Condition = std::conditional_t<std::is_same_v<Mutex, std::mutex>,
+          std::condition_variable, std::condition_variable_any>;
+
+      /* call under lock before adding one item; false if it mustn't be added */
+      bool MakeRoomI(std::unique_lock<Mutex>& lock)
+      {
+         if (closed_) { return false; }
+         if (capacity_ != 0 && queue_.size() >= capacity_) {
+            switch (overflow_) {
+            case Overflow::kBlock:
+               condition_.notify_all(); /* items pushed so far by push_range */
+               not_full_.wait(lock,
+                   [this] { return capacity_ == 0 || queue_.size() < capacity_ || closed_; });
+               break;
+            case Overflow::kDropOldest:
+               queue_.pop_front();
+               break;
+            case Overflow::kReject:
+               return false;
+            }
+         }
+         return !closed_;
+      }
+
+      /* call under lock after removing items. Unlocks first if producers may be waiting */
+      void NotifyNotFullI(std::unique_lock<Mutex>& lock)
+      {
+         if (capacity_ != 0 && overflow_ == Overflow::kBlock) {
+            lock.unlock();
+            not_full_.notify_all();
+         }
+      }
+
       Container queue_ {};
-      mutable std::conditional_t<std::is_same_v<Mutex, std::mutex>, std::condition_variable,
-          std::condition_variable_any>
-          condition_ {};
+      size_type capacity_ {0};
+      Overflow overflow_ {Overflow::kBlock};
+      bool closed_ {false};
+      mutable Condition condition_ {};
+      mutable Condition not_full_ {};
       mutable Mutex mutex_ {};
    };
 } // namespace rsj
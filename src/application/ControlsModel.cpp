@@ -16,53 +16,135 @@
 #include "ControlsModel.h"
 
 #include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <span>
 #include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
-double ChannelModel::OffsetResult(const int diff, const int controlnumber, const bool wrap)
-{
-   try {
-      const auto high_limit {cc_high_.at(controlnumber)};
-      Expects(diff <= high_limit && diff >= -high_limit);
-#ifdef __cpp_lib_atomic_ref
-      const std::atomic_ref cv {current_v_.at(controlnumber)};
-#else
-      auto& cv {current_v_.at(controlnumber)};
-#endif
-      auto old_v {cv.load(std::memory_order_acquire)};
-      int new_v {};
-      if (wrap) {
-         do {
-            new_v = old_v + diff;
-            if (new_v > high_limit) { new_v -= high_limit; }
-            else if (new_v < 0) {
-               new_v += high_limit;
+namespace {
+   struct CurvePoint {
+      double x;
+      double y;
+   };
+
+   /* "x:y x:y" to points sorted by x, clamped to 0-1, with the ends added when missing. Pairs
+    * that don't parse are skipped. */
+   [[nodiscard]] std::vector<CurvePoint> ParsePoints(const std::string& text)
+   {
+      std::vector<CurvePoint> points {{0.0, 0.0}};
+      std::string_view rest {text};
+      while (!rest.empty()) {
+         const auto start {rest.find_first_not_of(" ,;\t")};
+         if (start == std::string_view::npos) { break; }
+         rest.remove_prefix(start);
+         const auto token {rest.substr(0, rest.find_first_of(" ,;\t"))};
+         rest.remove_prefix(token.size());
+         if (const auto colon {token.find(':')}; colon != std::string_view::npos) {
+            try {
+               const auto x {std::stod(std::string(token.substr(0, colon)))};
+               const auto y {std::stod(std::string(token.substr(colon + 1)))};
+               if (x > 0.0 && x < 1.0) { points.push_back({x, std::clamp(y, 0.0, 1.0)}); }
+               else if (x == 0.0) {
+                  points.front().y = std::clamp(y, 0.0, 1.0);
+               }
+               else if (x == 1.0) {
+                  points.push_back({2.0, std::clamp(y, 0.0, 1.0)}); /* sorted last, moved below */
+               }
+               else { /* out of range, skip */
+               }
             }
-            else { /* no action needed */
+            catch (const std::logic_error&) { /* invalid_argument or out_of_range, skip */
             }
-         } while (!cv.compare_exchange_weak(old_v, new_v, std::memory_order_release,
-             std::memory_order_acquire));
+         }
       }
-      else [[likely]] {
-         do {
-            new_v = std::clamp(old_v + diff, 0, high_limit);
-         } while (!cv.compare_exchange_weak(old_v, new_v, std::memory_order_release,
-             std::memory_order_acquire));
+      std::stable_sort(points.begin() + 1, points.end(),
+          [](const CurvePoint& a, const CurvePoint& b) { return a.x < b.x; });
+      if (points.back().x == 2.0) { points.back().x = 1.0; }
+      else {
+         points.push_back({1.0, 1.0});
       }
-      return static_cast<double>(new_v) / static_cast<double>(high_limit);
+      return points;
    }
-   catch (const std::exception& e) {
-      MIDI2LR_E_RESPONSE;
-      throw;
+
+   /* position 0-1 in the control's range to the value sent to Lightroom, 0-1 */
+   [[nodiscard]] double ApplyCurve(const rsj::CurveSpec& curve,
+       const std::vector<CurvePoint>& points, const double x)
+   {
+      switch (curve.shape) {
+      case rsj::CCcurve::kLinear:
+         return x;
+      case rsj::CCcurve::kExponential:
+         {
+            const auto amount {rsj::ClampCurveAmount(curve.amount)};
+            if (amount == 0.0) { return x; }
+            return std::expm1(amount * x) / std::expm1(amount);
+         }
+      case rsj::CCcurve::kSCurve:
+         {
+            const auto amount {rsj::ClampCurveAmount(curve.amount)};
+            if (amount <= 0.0) { return x; }
+            const auto t {2.0 * x - 1.0};
+            return 0.5 + std::copysign(0.5 * std::pow(std::abs(t), amount), t);
+         }
+      case rsj::CCcurve::kPoints:
+         {
+            const auto upper {std::upper_bound(points.begin(), points.end(), x,
+                [](const double v, const CurvePoint& p) { return v < p.x; })};
+            if (upper == points.end()) { return points.back().y; }
+            if (upper == points.begin()) { return points.front().y; }
+            const auto& lo {*(upper - 1)};
+            if (upper->x == lo.x) { return upper->y; }
+            return lo.y + (x - lo.x) * (upper->y - lo.y) / (upper->x - lo.x);
+         }
+      }
+      return x;
+   }
+} // namespace
+
+double ChannelModel::OffsetResult(const int diff, const rsj::Control controlnumber,
+    const bool wrap) noexcept
+{
+   const auto high_limit {At(cc_high_, controlnumber)};
+   Expects(diff <= high_limit && diff >= -high_limit);
+#ifdef __cpp_lib_atomic_ref
+   const std::atomic_ref cv {At(current_v_, controlnumber)};
+#else
+   auto& cv {At(current_v_, controlnumber)};
+#endif
+   auto old_v {cv.load(std::memory_order_acquire)};
+   int new_v {};
+   if (wrap) {
+      do {
+         new_v = old_v + diff;
+         if (new_v > high_limit) { new_v -= high_limit; }
+         else if (new_v < 0) {
+            new_v += high_limit;
+         }
+         else { /* no action needed */
+         }
+      } while (!cv.compare_exchange_weak(old_v, new_v, std::memory_order_release,
+          std::memory_order_acquire));
+   }
+   else [[likely]] {
+      do {
+         new_v = std::clamp(old_v + diff, 0, high_limit);
+      } while (!cv.compare_exchange_weak(old_v, new_v, std::memory_order_release,
+          std::memory_order_acquire));
    }
+   return static_cast<double>(new_v) / static_cast<double>(high_limit);
 }
 
-double ChannelModel::ControllerToPlugin(const rsj::MessageType controltype, const int controlnumber,
-    const int value, const bool wrap)
+double ChannelModel::ControllerToPlugin(const rsj::MessageType controltype,
+    const rsj::Control controlnumber, const int value, const bool wrap)
 {
    try {
       Expects(controltype == rsj::MessageType::kCc
-                      && cc_method_.at(controlnumber) == rsj::CCmethod::kAbsolute
-                  ? cc_low_.at(controlnumber) < cc_high_.at(controlnumber)
+                      && At(cc_method_, controlnumber) == rsj::CCmethod::kAbsolute
+                  ? At(cc_low_, controlnumber) < At(cc_high_, controlnumber)
                   : 1);
       Expects(controltype == rsj::MessageType::kPw ? pitch_wheel_max_ > pitch_wheel_min_ : 1);
       Expects(controltype == rsj::MessageType::kPw
@@ -77,21 +159,27 @@ double ChannelModel::ControllerToPlugin(const rsj::MessageType controltype, cons
          return static_cast<double>(value - pitch_wheel_min_)
                 / static_cast<double>(pitch_wheel_max_ - pitch_wheel_min_);
       case rsj::MessageType::kCc:
-         switch (cc_method_.at(controlnumber)) {
+         switch (At(cc_method_, controlnumber)) {
          case rsj::CCmethod::kAbsolute:
 #ifdef __cpp_lib_atomic_ref
-            std::atomic_ref(current_v_.at(controlnumber)).store(value, std::memory_order_release);
+            std::atomic_ref(At(current_v_, controlnumber)).store(value, std::memory_order_release);
 #else
-            current_v_.at(controlnumber).store(value, std::memory_order_release);
+            At(current_v_, controlnumber).store(value, std::memory_order_release);
 #endif
+            if (const auto* table {Table(controlnumber)}) {
+               /* NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic) */
+               return table[std::clamp(value, 0, controlnumber.IsNrpn() ? kMaxNrpn : kMaxMidi)];
+            }
 #pragma warning(suppress : 26451) /* int subtraction won't overflow 4 bytes here */
-            return static_cast<double>(value - cc_low_.at(controlnumber))
-                   / static_cast<double>(cc_high_.at(controlnumber) - cc_low_.at(controlnumber));
+            return static_cast<double>(value - At(cc_low_, controlnumber))
+                   / static_cast<double>(At(cc_high_, controlnumber) - At(cc_low_, controlnumber));
          case rsj::CCmethod::kBinaryOffset:
-            if (IsNrpn(controlnumber)) { return OffsetResult(value - kBit14, controlnumber, wrap); }
+            if (controlnumber.IsNrpn()) {
+               return OffsetResult(value - kBit14, controlnumber, wrap);
+            }
             return OffsetResult(value - kBit7, controlnumber, wrap);
          case rsj::CCmethod::kSignMagnitude:
-            if (IsNrpn(controlnumber)) {
+            if (controlnumber.IsNrpn()) {
                return OffsetResult(value & kBit14 ? -(value & kLow13Bits) : value, controlnumber,
                    wrap);
             }
@@ -99,7 +187,7 @@ double ChannelModel::ControllerToPlugin(const rsj::MessageType controltype, cons
          case rsj::CCmethod::kTwosComplement:
             /* SEE:https://en.wikipedia.org/wiki/Signed_number_representations#Two.27s_complement
              * flip twos comp and subtract--independent of processor architecture */
-            if (IsNrpn(controlnumber)) {
+            if (controlnumber.IsNrpn()) {
                return OffsetResult(value & kBit14 ? -((value ^ kMaxNrpn) + 1) : value,
                    controlnumber, wrap);
             }
@@ -108,7 +196,7 @@ double ChannelModel::ControllerToPlugin(const rsj::MessageType controltype, cons
          }
       case rsj::MessageType::kNoteOn:
          return static_cast<double>(value)
-                / static_cast<double>((IsNrpn(controlnumber) ? kMaxNrpn : kMaxMidi));
+                / static_cast<double>((controlnumber.IsNrpn() ? kMaxNrpn : kMaxMidi));
       case rsj::MessageType::kNoteOff:
          return 0.0;
       case rsj::MessageType::kChanPressure:
@@ -118,7 +206,7 @@ double ChannelModel::ControllerToPlugin(const rsj::MessageType controltype, cons
          throw std::invalid_argument(fmt::format(
              FMT_STRING("ChannelModel::ControllerToPlugin unexpected control type. Controltype {}, "
                         "controlnumber {}, value {}, wrap {}."),
-             controltype, controlnumber, value, wrap));
+             controltype, controlnumber.Get(), value, wrap));
       }
       throw std::domain_error(fmt::format(FMT_STRING("Undefined control type in "
                                                      "ChannelModel::PluginToController. "
@@ -133,48 +221,43 @@ double ChannelModel::ControllerToPlugin(const rsj::MessageType controltype, cons
 
 /* Note: rounding up on set to center (adding remainder of %2) to center the control's LED when
  * centered */
-int ChannelModel::SetToCenter(const rsj::MessageType controltype, const int controlnumber)
+int ChannelModel::SetToCenter(const rsj::MessageType controltype,
+    const rsj::Control controlnumber) noexcept
 {
-   try {
-      auto retval {0};
-      switch (controltype) {
-      case rsj::MessageType::kPw:
-         retval = CenterPw();
-         pitch_wheel_current_.store(retval, std::memory_order_release);
-         break;
-      case rsj::MessageType::kCc:
-         if (cc_method_.at(controlnumber) == rsj::CCmethod::kAbsolute) {
-            retval = CenterCc(controlnumber);
+   auto retval {0};
+   switch (controltype) {
+   case rsj::MessageType::kPw:
+      retval = CenterPw();
+      pitch_wheel_current_.store(retval, std::memory_order_release);
+      break;
+   case rsj::MessageType::kCc:
+      if (At(cc_method_, controlnumber) == rsj::CCmethod::kAbsolute) {
+         retval = CenterCc(controlnumber);
 #ifdef __cpp_lib_atomic_ref
-            std::atomic_ref(current_v_.at(controlnumber)).store(retval, std::memory_order_release);
+         std::atomic_ref(At(current_v_, controlnumber)).store(retval, std::memory_order_release);
 #else
-            current_v_.at(controlnumber).store(retval, std::memory_order_release);
+         At(current_v_, controlnumber).store(retval, std::memory_order_release);
 #endif
-         }
-         break;
-      case rsj::MessageType::kChanPressure:
-      case rsj::MessageType::kKeyPressure:
-      case rsj::MessageType::kNoteOff:
-      case rsj::MessageType::kNoteOn:
-      case rsj::MessageType::kPgmChange:
-      case rsj::MessageType::kSystem:
-         break;
       }
-      return retval;
-   }
-   catch (const std::exception& e) {
-      MIDI2LR_E_RESPONSE;
-      throw;
+      break;
+   case rsj::MessageType::kChanPressure:
+   case rsj::MessageType::kKeyPressure:
+   case rsj::MessageType::kNoteOff:
+   case rsj::MessageType::kNoteOn:
+   case rsj::MessageType::kPgmChange:
+   case rsj::MessageType::kSystem:
+      break;
    }
+   return retval;
 }
 
-int ChannelModel::MeasureChange(const rsj::MessageType controltype, const int controlnumber,
-    const int value)
+int ChannelModel::MeasureChange(const rsj::MessageType controltype,
+    const rsj::Control controlnumber, const int value)
 {
    try {
       Expects(controltype == rsj::MessageType::kCc
-                      && cc_method_.at(controlnumber) == rsj::CCmethod::kAbsolute
-                  ? cc_low_.at(controlnumber) < cc_high_.at(controlnumber)
+                      && At(cc_method_, controlnumber) == rsj::CCmethod::kAbsolute
+                  ? At(cc_low_, controlnumber) < At(cc_high_, controlnumber)
                   : 1);
       Expects(controltype == rsj::MessageType::kPw ? pitch_wheel_max_ > pitch_wheel_min_ : 1);
       Expects(controltype == rsj::MessageType::kPw
@@ -186,25 +269,25 @@ int ChannelModel::MeasureChange(const rsj::MessageType controltype, const int co
       case rsj::MessageType::kPw:
          return value - pitch_wheel_current_.exchange(value, std::memory_order_acq_rel);
       case rsj::MessageType::kCc:
-         switch (cc_method_.at(controlnumber)) {
+         switch (At(cc_method_, controlnumber)) {
          case rsj::CCmethod::kAbsolute:
 #ifdef __cpp_lib_atomic_ref
             return value
-                   - std::atomic_ref(current_v_.at(controlnumber))
+                   - std::atomic_ref(At(current_v_, controlnumber))
                          .exchange(value, std::memory_order_acq_rel);
 #else
-            return value - current_v_.at(controlnumber).exchange(value, std::memory_order_acq_rel);
+            return value - At(current_v_, controlnumber).exchange(value, std::memory_order_acq_rel);
 #endif
          case rsj::CCmethod::kBinaryOffset:
-            if (IsNrpn(controlnumber)) { return value - kBit14; }
+            if (controlnumber.IsNrpn()) { return value - kBit14; }
             return value - kBit7;
          case rsj::CCmethod::kSignMagnitude:
-            if (IsNrpn(controlnumber)) { return value & kBit14 ? -(value & kLow13Bits) : value; }
+            if (controlnumber.IsNrpn()) { return value & kBit14 ? -(value & kLow13Bits) : value; }
             return value & kBit7 ? -(value & kLow6Bits) : value;
          case rsj::CCmethod::kTwosComplement:
             /* SEE:https://en.wikipedia.org/wiki/Signed_number_representations#Two.27s_complement
              * flip twos comp and subtract--independent of processor architecture */
-            if (IsNrpn(controlnumber)) {
+            if (controlnumber.IsNrpn()) {
                return value & kBit14 ? -((value ^ kMaxNrpn) + 1) : value;
             }
             return value & kBit7 ? -((value ^ kMaxMidi) + 1) : value;
@@ -219,7 +302,7 @@ int ChannelModel::MeasureChange(const rsj::MessageType controltype, const int co
          throw std::invalid_argument(
              fmt::format(FMT_STRING("ChannelModel::MeasureChange unexpected control type. "
                                     "Controltype {}, controlnumber {}, value {}."),
-                 controltype, controlnumber, value));
+                 controltype, controlnumber.Get(), value));
       }
       throw std::domain_error(fmt::format(FMT_STRING("Undefined control type in "
                                                      "ChannelModel::PluginToController. "
@@ -235,8 +318,8 @@ int ChannelModel::MeasureChange(const rsj::MessageType controltype, const int co
 #pragma warning(push)
 #pragma warning(disable : 26451) /* see TODO below */
 
-int ChannelModel::PluginToController(const rsj::MessageType controltype, const int controlnumber,
-    const double value)
+int ChannelModel::PluginToController(const rsj::MessageType controltype,
+    const rsj::Control controlnumber, const double value)
 {
    try {
       /* value effectively clamped to 0-1 by clamp calls below */
@@ -255,8 +338,25 @@ int ChannelModel::PluginToController(const rsj::MessageType controltype, const i
       case rsj::MessageType::kCc:
          {
             /* TODO(C26451): int subtraction: can it overflow? */
-            const auto clow {cc_low_.at(controlnumber)};
-            const auto chigh {cc_high_.at(controlnumber)};
+            const auto clow {At(cc_low_, controlnumber)};
+            const auto chigh {At(cc_high_, controlnumber)};
+            if (const auto* table {Table(controlnumber)};
+                table && At(cc_method_, controlnumber) == rsj::CCmethod::kAbsolute) {
+               /* curves are nondecreasing: the first position that reaches the value */
+               const std::span values {table, gsl::narrow_cast<size_t>(chigh) + 1};
+               auto pos {gsl::narrow_cast<int>(
+                   std::lower_bound(values.begin() + clow, values.end(), value) - values.begin())};
+               if (pos > chigh) { pos = chigh; }
+               else if (pos > clow && value - values[pos - 1] < values[pos] - value) {
+                  --pos; /* nearer */
+               }
+#ifdef __cpp_lib_atomic_ref
+               std::atomic_ref(At(current_v_, controlnumber)).store(pos, std::memory_order_release);
+#else
+               At(current_v_, controlnumber).store(pos, std::memory_order_release);
+#endif
+               return pos;
+            }
 #ifdef _WIN32
             const auto newv {
                 std::clamp(_cvt_dtoi_fast(value * static_cast<double>(chigh - clow) + 0.5) + clow,
@@ -267,9 +367,9 @@ int ChannelModel::PluginToController(const rsj::MessageType controltype, const i
                 chigh)};
 #endif
 #ifdef __cpp_lib_atomic_ref
-            std::atomic_ref(current_v_.at(controlnumber)).store(newv, std::memory_order_release);
+            std::atomic_ref(At(current_v_, controlnumber)).store(newv, std::memory_order_release);
 #else
-            current_v_.at(controlnumber).store(newv, std::memory_order_release);
+            At(current_v_, controlnumber).store(newv, std::memory_order_release);
 #endif
             return newv;
          }
@@ -298,14 +398,17 @@ int ChannelModel::PluginToController(const rsj::MessageType controltype, const i
 
 #pragma warning(pop)
 
-void ChannelModel::SetCc(const int controlnumber, const int min, const int max,
-    const rsj::CCmethod controltype)
+void ChannelModel::SetCc(const rsj::Control controlnumber, const int min, const int max,
+    const rsj::CCmethod controltype, const rsj::CurveSpec& curve)
 {
    try {
-      /* CcMethod has to be set before others or ranges won't be correct */
+      /* CcMethod has to be set before others or ranges won't be correct. Curve is set last, so
+       * its table is built once, for the final range */
+      cc_curves_.erase(controlnumber.Get());
       SetCcMethod(controlnumber, controltype);
       SetCcMin(controlnumber, min);
       SetCcMax(controlnumber, max);
+      SetCcCurve(controlnumber, curve);
    }
    catch (const std::exception& e) {
       MIDI2LR_E_RESPONSE;
@@ -313,15 +416,19 @@ void ChannelModel::SetCc(const int controlnumber, const int min, const int max,
    }
 }
 
-void ChannelModel::SetCcAll(const int controlnumber, const int min, const int max,
-    const rsj::CCmethod controltype)
+void ChannelModel::SetCcAll(const rsj::Control controlnumber, const int min, const int max,
+    const rsj::CCmethod controltype, const rsj::CurveSpec& curve)
 {
    try {
-      if (IsNrpn(controlnumber)) {
-         for (auto a {kMaxMidi + 1}; a <= kMaxNrpn; ++a) { SetCc(a, min, max, controltype); }
+      if (controlnumber.IsNrpn()) {
+         for (auto a {kMaxMidi + 1}; a <= kMaxNrpn; ++a) {
+            SetCc(rsj::Control(a), min, max, controltype, curve);
+         }
       }
       else {
-         for (auto a {0}; a <= kMaxMidi; ++a) { SetCc(a, min, max, controltype); }
+         for (auto a {0}; a <= kMaxMidi; ++a) {
+            SetCc(rsj::Control(a), min, max, controltype, curve);
+         }
       }
    }
    catch (const std::exception& e) {
@@ -330,24 +437,40 @@ void ChannelModel::SetCcAll(const int controlnumber, const int min, const int ma
    }
 }
 
-void ChannelModel::SetCcMax(const int controlnumber, const int value)
+rsj::CurveSpec ChannelModel::GetCcCurve(const rsj::Control controlnumber) const
 {
    try {
-      Expects(value <= kMaxNrpn && value >= 0);
-      if (cc_method_.at(controlnumber) != rsj::CCmethod::kAbsolute) {
-         cc_high_.at(controlnumber) = value < 0 ? 1000 : value;
+      if (const auto found {cc_curves_.find(controlnumber.Get())}; found != cc_curves_.end()) {
+         return found->second;
       }
+      return {};
+   }
+   catch (const std::exception& e) {
+      MIDI2LR_E_RESPONSE;
+      throw;
+   }
+}
+
+void ChannelModel::SetCcCurve(const rsj::Control controlnumber, const rsj::CurveSpec& curve)
+{
+   try {
+      if (curve.shape == rsj::CCcurve::kLinear) { cc_curves_.erase(controlnumber.Get()); }
       else {
-         const auto max {IsNrpn(controlnumber) ? kMaxNrpn : kMaxMidi};
-         cc_high_.at(controlnumber) =
-             value <= cc_low_.at(controlnumber) || value > max ? max : value;
+         cc_curves_.insert_or_assign(controlnumber.Get(), curve);
       }
-#ifdef __cpp_lib_atomic_ref
-      std::atomic_ref(current_v_.at(controlnumber))
-          .store(CenterCc(controlnumber), std::memory_order_release);
-#else
-      current_v_.at(controlnumber).store(CenterCc(controlnumber), std::memory_order_release);
-#endif
+      BuildTable(controlnumber);
+   }
+   catch (const std::exception& e) {
+      MIDI2LR_E_RESPONSE;
+      throw;
+   }
+}
+
+void ChannelModel::SetCcMethod(const rsj::Control controlnumber, const rsj::CCmethod value)
+{
+   try {
+      At(cc_method_, controlnumber) = value;
+      BuildTable(controlnumber);
    }
    catch (const std::exception& e) {
       MIDI2LR_E_RESPONSE;
@@ -355,21 +478,46 @@ void ChannelModel::SetCcMax(const int controlnumber, const int value)
    }
 }
 
-void ChannelModel::SetCcMin(const int controlnumber, const int value)
+/* Runs on the message thread. The dispatch thread reads the table pointer, so a table is never
+ * changed or freed once published */
+void ChannelModel::BuildTable(const rsj::Control controlnumber)
 {
    try {
-      if (cc_method_.at(controlnumber) != rsj::CCmethod::kAbsolute) {
-         cc_low_.at(controlnumber) = 0;
+      auto& slot {At(cc_table_, controlnumber)};
+      const auto found {cc_curves_.find(controlnumber.Get())};
+      if (found == cc_curves_.end()
+          || At(cc_method_, controlnumber) != rsj::CCmethod::kAbsolute) {
+         slot.store(nullptr, std::memory_order_release);
+         return;
       }
-      else {
-         cc_low_.at(controlnumber) = value < 0 || value >= cc_high_.at(controlnumber) ? 0 : value;
+      const auto& curve {found->second};
+      const auto low {At(cc_low_, controlnumber)};
+      const auto high {At(cc_high_, controlnumber)};
+      const auto size {gsl::narrow_cast<size_t>(controlnumber.IsNrpn() ? kMaxNrpn : kMaxMidi) + 1};
+      const auto existing {std::find_if(curve_tables_.begin(), curve_tables_.end(),
+          [&](const CurveTable& t) {
+             return t.low == low && t.high == high && t.values.size() == size && t.curve == curve;
+          })};
+      if (existing != curve_tables_.end()) {
+         slot.store(existing->values.data(), std::memory_order_release);
+         return;
       }
-#ifdef __cpp_lib_atomic_ref
-      std::atomic_ref(current_v_.at(controlnumber))
-          .store(CenterCc(controlnumber), std::memory_order_release);
-#else
-      current_v_.at(controlnumber).store(CenterCc(controlnumber), std::memory_order_release);
-#endif
+      const auto points {curve.shape == rsj::CCcurve::kPoints ? ParsePoints(curve.points)
+                                                              : std::vector<CurvePoint> {}};
+      std::vector<double> values(size);
+      auto previous {0.0};
+      for (size_t v {0}; v < size; ++v) {
+         const auto x {std::clamp(static_cast<double>(static_cast<int>(v) - low)
+                                      / static_cast<double>(high - low),
+             0.0, 1.0)};
+         /* kept nondecreasing, so PluginToController can search it */
+         previous = std::max(previous, std::clamp(ApplyCurve(curve, points, x), 0.0, 1.0));
+#pragma warning(suppress : 26446) /* v < size */
+         values[v] = previous;
+      }
+      const auto& table {curve_tables_.emplace_back(CurveTable {curve, low, high,
+          std::move(values)})};
+      slot.store(table.values.data(), std::memory_order_release);
    }
    catch (const std::exception& e) {
       MIDI2LR_E_RESPONSE;
@@ -377,6 +525,58 @@ void ChannelModel::SetCcMin(const int controlnumber, const int value)
    }
 }
 
+/* Rescales the position into the changed range instead of recentering it, so a relative control
+ * seeded from Lightroom's value keeps it when its limits are edited or loaded */
+void ChannelModel::KeepPosition(const rsj::Control controlnumber, const int old_low,
+    const int old_high) noexcept
+{
+   const auto low {At(cc_low_, controlnumber)};
+   const auto high {At(cc_high_, controlnumber)};
+#ifdef __cpp_lib_atomic_ref
+   const std::atomic_ref cv {At(current_v_, controlnumber)};
+#else
+   auto& cv {At(current_v_, controlnumber)};
+#endif
+   auto new_v {CenterCc(controlnumber)};
+   if (old_high > old_low) {
+      const auto fraction {static_cast<double>(cv.load(std::memory_order_acquire) - old_low)
+                           / static_cast<double>(old_high - old_low)};
+      new_v = gsl::narrow_cast<int>(std::lround(fraction * static_cast<double>(high - low))) + low;
+   }
+   cv.store(std::clamp(new_v, low, high), std::memory_order_release);
+}
+
+void ChannelModel::SetCcMax(const rsj::Control controlnumber, const int value)
+{
+   Expects(value <= kMaxNrpn && value >= 0);
+   const auto old_low {At(cc_low_, controlnumber)};
+   const auto old_high {At(cc_high_, controlnumber)};
+   if (At(cc_method_, controlnumber) != rsj::CCmethod::kAbsolute) {
+      At(cc_high_, controlnumber) = value < 0 ? 1000 : value;
+   }
+   else {
+      const auto max {controlnumber.IsNrpn() ? kMaxNrpn : kMaxMidi};
+      At(cc_high_, controlnumber) =
+          value <= At(cc_low_, controlnumber) || value > max ? max : value;
+   }
+   KeepPosition(controlnumber, old_low, old_high);
+   BuildTable(controlnumber);
+}
+
+void ChannelModel::SetCcMin(const rsj::Control controlnumber, const int value)
+{
+   const auto old_low {At(cc_low_, controlnumber)};
+   const auto old_high {At(cc_high_, controlnumber)};
+   if (At(cc_method_, controlnumber) != rsj::CCmethod::kAbsolute) {
+      At(cc_low_, controlnumber) = 0;
+   }
+   else {
+      At(cc_low_, controlnumber) = value < 0 || value >= At(cc_high_, controlnumber) ? 0 : value;
+   }
+   KeepPosition(controlnumber, old_low, old_high);
+   BuildTable(controlnumber);
+}
+
 void ChannelModel::SetPwMax(const int value) noexcept
 {
    pitch_wheel_max_ = value > kMaxNrpn || value <= pitch_wheel_min_ ? kMaxNrpn : value;
@@ -393,18 +593,30 @@ void ChannelModel::ActiveToSaved() const
 {
    try {
       settings_to_save_.clear();
-      for (auto i {0}; i <= kMaxMidi; ++i) {
-         if (cc_method_.at(i) != rsj::CCmethod::kAbsolute || cc_high_.at(i) != kMaxMidi
-             || cc_low_.at(i) != 0) {
-            settings_to_save_.emplace_back(i, cc_low_.at(i), cc_high_.at(i), cc_method_.at(i));
+      for (auto i {0}; i <= kMaxNrpn; ++i) {
+         const rsj::Control control {i};
+         const auto curve {cc_curves_.find(i)};
+         const auto low {At(cc_low_, control)};
+         const auto high {At(cc_high_, control)};
+         const auto method {At(cc_method_, control)};
+         if (method != rsj::CCmethod::kAbsolute || high != (control.IsNrpn() ? kMaxNrpn : kMaxMidi)
+             || low != 0 || curve != cc_curves_.end()) {
+            settings_to_save_.emplace_back(i, low, high, method,
+                curve != cc_curves_.end() ? curve->second : rsj::CurveSpec {});
          }
       }
-      for (auto i {kMaxMidi + 1}; i <= kMaxNrpn; ++i) {
-         if (cc_method_.at(i) != rsj::CCmethod::kAbsolute || cc_high_.at(i) != kMaxNrpn
-             || cc_low_.at(i) != 0) {
-            settings_to_save_.emplace_back(i, cc_low_.at(i), cc_high_.at(i), cc_method_.at(i));
-         }
+      positions_to_save_.clear();
+      for (auto i {0}; i <= kMaxNrpn; ++i) {
+         const rsj::Control control {i};
+#ifdef __cpp_lib_atomic_ref
+         const auto value {
+             std::atomic_ref(At(current_v_, control)).load(std::memory_order_acquire)};
+#else
+         const auto value {At(current_v_, control).load(std::memory_order_acquire)};
+#endif
+         if (value != CenterCc(control)) { positions_to_save_.push_back({i, value}); }
       }
+      pitch_wheel_to_save_ = pitch_wheel_current_.load(std::memory_order_acquire);
    }
    catch (const std::exception& e) {
       MIDI2LR_E_RESPONSE;
@@ -412,28 +624,23 @@ void ChannelModel::ActiveToSaved() const
    }
 }
 
-void ChannelModel::CcDefaults()
+void ChannelModel::CcDefaults() noexcept
 {
-   try {
-      cc_low_.fill(0);
-      cc_high_.fill(kMaxNrpn);
-      cc_method_.fill(rsj::CCmethod::kAbsolute);
+   cc_low_.fill(0);
+   cc_high_.fill(kMaxNrpn);
+   cc_method_.fill(rsj::CCmethod::kAbsolute);
+   cc_curves_.clear();
+   for (auto& table : cc_table_) { table.store(nullptr, std::memory_order_relaxed); }
 #ifdef __cpp_lib_atomic_ref
-      current_v_.fill(kMaxNrpnHalf);
-      std::fill_n(cc_high_.begin(), kMaxMidi + 1, kMaxMidi);
-      std::fill_n(current_v_.begin(), kMaxMidi + 1, kMaxMidiHalf);
+   current_v_.fill(kMaxNrpnHalf);
+   std::fill_n(cc_high_.begin(), kMaxMidi + 1, kMaxMidi);
+   std::fill_n(current_v_.begin(), kMaxMidi + 1, kMaxMidiHalf);
 #else
-      for (auto&& a : current_v_) { a.store(kMaxNrpnHalf, std::memory_order_relaxed); }
-      std::fill_n(cc_high_.begin(), kMaxMidi + 1, kMaxMidi);
-      for (size_t a {0}; a <= kMaxMidi; ++a) {
-         current_v_.at(a).store(kMaxMidiHalf, std::memory_order_relaxed);
-      }
+   for (auto&& a : current_v_) { a.store(kMaxNrpnHalf, std::memory_order_relaxed); }
+   std::fill_n(cc_high_.begin(), kMaxMidi + 1, kMaxMidi);
+   std::for_each_n(current_v_.begin(), kMaxMidi + 1,
+       [](auto& a) { a.store(kMaxMidiHalf, std::memory_order_relaxed); });
 #endif
-   }
-   catch (const std::exception& e) {
-      MIDI2LR_E_RESPONSE;
-      throw;
-   }
 }
 
 void ChannelModel::SavedToActive()
@@ -441,7 +648,7 @@ void ChannelModel::SavedToActive()
    try {
       CcDefaults();
       for (const auto& set : settings_to_save_) {
-         SetCc(set.control_number, set.low, set.high, set.method);
+         SetCc(rsj::Control(set.control_number), set.low, set.high, set.method, set.curve);
       }
    }
    catch (const std::exception& e) {
@@ -450,13 +657,23 @@ void ChannelModel::SavedToActive()
    }
 }
 
-#pragma warning(push)
-#pragma warning(disable : 26455)
-
-ChannelModel::ChannelModel()
+/* after SavedToActive, so saved positions are clamped to the loaded ranges */
+void ChannelModel::SavedPositionsToActive()
 {
    try {
-      CcDefaults();
+      for (const auto& pos : positions_to_save_) {
+         if (pos.control_number < 0 || pos.control_number > kMaxNrpn) { continue; }
+         const rsj::Control control {pos.control_number};
+         const auto value {std::clamp(pos.value, At(cc_low_, control), At(cc_high_, control))};
+#ifdef __cpp_lib_atomic_ref
+         std::atomic_ref(At(current_v_, control)).store(value, std::memory_order_release);
+#else
+         At(current_v_, control).store(value, std::memory_order_release);
+#endif
+      }
+      pitch_wheel_current_.store(std::clamp(pitch_wheel_to_save_, pitch_wheel_min_,
+                                     pitch_wheel_max_),
+          std::memory_order_release);
    }
    catch (const std::exception& e) {
       MIDI2LR_E_RESPONSE;
@@ -464,4 +681,7 @@ ChannelModel::ChannelModel()
    }
 }
 
-#pragma warning(pop)
\ No newline at end of file
+ChannelModel::ChannelModel() noexcept
+{
+   CcDefaults();
+}
\ No newline at end of file
@@ -16,9 +16,15 @@
  *
  */
 //-V813_MINSIZE=13 /*warn if passing structure by value > 12 bytes (3*sizeof(int)) */
+#include <algorithm>
 #include <array>
 #include <atomic>
+#include <cmath>
+#include <deque>
 #include <exception>
+#include <map>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include <cereal/access.hpp>
@@ -32,16 +38,41 @@
 namespace rsj {
    enum struct CCmethod : char { kAbsolute, kTwosComplement, kBinaryOffset, kSignMagnitude };
 
+   /* Response curve of an absolute control, applied to its position in the low-high range before
+    * the value goes to Lightroom. kExponential: amount is the steepness, above 0 gives fine control
+    * at the low end, below 0 at the high end. kSCurve: amount is an exponent, above 1 gives fine
+    * control near the center, below 1 near the ends. kPoints: points are "x:y" pairs from 0 to 1,
+    * separated by spaces, joined by straight lines; 0:0 and 1:1 are implied. */
+   enum struct CCcurve : char { kLinear, kExponential, kSCurve, kPoints };
+
+   struct CurveSpec {
+      CCcurve shape {CCcurve::kLinear};
+      double amount {0.0};
+      std::string points {};
+      bool operator==(const CurveSpec& other) const = default;
+   };
+
+   /* Beyond this the curves are flat to within a controller step, and expm1 overflows past about
+    * 709. Not finite counts as no curve. */
+   inline constexpr double kMaxCurveAmount {50.0};
+
+   [[nodiscard]] inline double ClampCurveAmount(const double amount) noexcept
+   {
+      if (!std::isfinite(amount)) { return 0.0; }
+      return std::clamp(amount, -kMaxCurveAmount, kMaxCurveAmount);
+   }
+
    struct SettingsStruct {
       int control_number {};
       int low {};
       int high {};
       rsj::CCmethod method {};
+      rsj::CurveSpec curve {};
 
       // ReSharper disable once CppNonExplicitConvertingConstructor
-      SettingsStruct(int n = 0, int l = 0, int h = 0x7F,
-          rsj::CCmethod m = rsj::CCmethod::kAbsolute) noexcept
-          : control_number {n}, low {l}, high {h}, method {m}
+      SettingsStruct(int n = 0, int l = 0, int h = 0x7F, rsj::CCmethod m = rsj::CCmethod::kAbsolute,
+          rsj::CurveSpec c = {}) noexcept
+          : control_number {n}, low {l}, high {h}, method {m}, curve {std::move(c)}
       {
       }
 
@@ -54,6 +85,9 @@ namespace rsj {
          case 1:
             archive(control_number, high, low, method);
             break;
+         case 2:
+            archive(control_number, high, low, method, curve.shape, curve.amount, curve.points);
+            break;
          default:
             {
                constexpr auto msg {
@@ -74,6 +108,7 @@ namespace rsj {
          try {
             switch (version) {
             case 1:
+            case 2:
                {
                   std::string methodstr {"undefined"};
                   switch (method) {
@@ -107,6 +142,7 @@ namespace rsj {
                      method = CCmethod::kAbsolute;
                      break;
                   }
+                  if (version >= 2) { SerializeCurve(archive); }
                   break;
                }
             default:
@@ -126,6 +162,63 @@ namespace rsj {
             throw;
          }
       }
+
+    private:
+      template<class Archive> void SerializeCurve(Archive& archive)
+      {
+         std::string curvestr {"Linear"};
+         switch (curve.shape) {
+         case CCcurve::kLinear:
+            break;
+         case CCcurve::kExponential:
+            curvestr = "Exponential";
+            break;
+         case CCcurve::kSCurve:
+            curvestr = "SCurve";
+            break;
+         case CCcurve::kPoints:
+            curvestr = "Points";
+            break;
+         }
+         archive(cereal::make_nvp("curve", curvestr), cereal::make_nvp("amount", curve.amount),
+             cereal::make_nvp("points", curve.points));
+         switch (curvestr.empty() ? 'L' : curvestr.front()) {
+         case 'E':
+            curve.shape = CCcurve::kExponential;
+            break;
+         case 'S':
+            curve.shape = CCcurve::kSCurve;
+            break;
+         case 'P':
+            curve.shape = CCcurve::kPoints;
+            break;
+         case 'L':
+         default:
+            curve.shape = CCcurve::kLinear;
+            break;
+         }
+      }
+   };
+
+   /* last known position of a control, saved so relative controls resume from it after a restart
+    */
+   struct ControlPosition {
+      int control_number {};
+      int value {};
+
+      template<class Archive> void serialize(Archive& archive, const uint32_t version)
+      {
+         if (version == 1) {
+            archive(cereal::make_nvp("CC", control_number), CEREAL_NVP(value));
+         }
+         else {
+            constexpr auto msg {
+                "The file, 'settings.xml', is marked as a version not supported by the current "
+                "version of MIDI2LR ControlPosition, and won't be loaded. File version: {}."};
+            rsj::LogAndAlertError(fmt::format(juce::translate(msg).toStdString(), version),
+                fmt::format(msg, version));
+         }
+      }
    };
 } // namespace rsj
 
@@ -138,49 +231,66 @@ class ChannelModel {
    static constexpr int kMaxMidiHalf {kMaxMidi / 2};
    static constexpr int kMaxNrpn {0x3FFF};
    static constexpr int kMaxNrpnHalf {kMaxNrpn / 2};
-   static constexpr size_t kMaxControls {0x4000};
+   static constexpr size_t kMaxControls {rsj::Control::kCount};
+
+   /* rsj::Control is always in range, so the per-control tables are indexed without checks */
+   template<class Table> [[nodiscard]] static auto& At(Table& table, rsj::Control control) noexcept
+   {
+#pragma warning(suppress : 26446 26482)
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+      return table[control.Index()];
+   }
 
  public:
-   ChannelModel();
-   double ControllerToPlugin(rsj::MessageType controltype, int controlnumber, int value, bool wrap);
-   int MeasureChange(rsj::MessageType controltype, int controlnumber, int value);
-   int SetToCenter(rsj::MessageType controltype, int controlnumber);
+   ChannelModel() noexcept;
+   double ControllerToPlugin(rsj::MessageType controltype, rsj::Control controlnumber, int value,
+       bool wrap);
+   int MeasureChange(rsj::MessageType controltype, rsj::Control controlnumber, int value);
+   int SetToCenter(rsj::MessageType controltype, rsj::Control controlnumber) noexcept;
 
-   [[nodiscard]] rsj::CCmethod GetCcMethod(int controlnumber) const
+   [[nodiscard]] rsj::CCmethod GetCcMethod(rsj::Control controlnumber) const noexcept
    {
-      return cc_method_.at(controlnumber);
+      return At(cc_method_, controlnumber);
    }
 
-   [[nodiscard]] int GetCcMax(int controlnumber) const { return cc_high_.at(controlnumber); }
+   [[nodiscard]] rsj::CurveSpec GetCcCurve(rsj::Control controlnumber) const;
 
-   [[nodiscard]] int GetCcMin(int controlnumber) const { return cc_low_.at(controlnumber); }
+   [[nodiscard]] int GetCcMax(rsj::Control controlnumber) const noexcept
+   {
+      return At(cc_high_, controlnumber);
+   }
+
+   [[nodiscard]] int GetCcMin(rsj::Control controlnumber) const noexcept
+   {
+      return At(cc_low_, controlnumber);
+   }
 
    [[nodiscard]] int GetPwMax() const noexcept { return pitch_wheel_max_; }
 
    [[nodiscard]] int GetPwMin() const noexcept { return pitch_wheel_min_; }
 
-   int PluginToController(rsj::MessageType controltype, int controlnumber, double value);
-   void SetCc(int controlnumber, int min, int max, rsj::CCmethod controltype);
-   void SetCcAll(int controlnumber, int min, int max, rsj::CCmethod controltype);
-   void SetCcMax(int controlnumber, int value);
+   int PluginToController(rsj::MessageType controltype, rsj::Control controlnumber, double value);
+   void SetCc(rsj::Control controlnumber, int min, int max, rsj::CCmethod controltype,
+       const rsj::CurveSpec& curve);
+   void SetCcAll(rsj::Control controlnumber, int min, int max, rsj::CCmethod controltype,
+       const rsj::CurveSpec& curve);
+   void SetCcCurve(rsj::Control controlnumber, const rsj::CurveSpec& curve);
+   void SetCcMax(rsj::Control controlnumber, int value);
 
-   void SetCcMethod(int controlnumber, rsj::CCmethod value)
-   {
-      cc_method_.at(controlnumber) = value;
-   }
+   void SetCcMethod(rsj::Control controlnumber, rsj::CCmethod value);
 
-   void SetCcMin(int controlnumber, int value);
+   void SetCcMin(rsj::Control controlnumber, int value);
    void SetPwMax(int value) noexcept;
    void SetPwMin(int value) noexcept;
 
  private:
    friend class cereal::access;
 
-   [[nodiscard]] int CenterCc(int controlnumber) const noexcept
+   [[nodiscard]] int CenterCc(rsj::Control controlnumber) const noexcept
    {
-      return (cc_high_.at(controlnumber) - cc_low_.at(controlnumber)) / 2
-             + cc_low_.at(controlnumber)
-             + (cc_high_.at(controlnumber) - cc_low_.at(controlnumber)) % 2;
+      const auto high {At(cc_high_, controlnumber)};
+      const auto low {At(cc_low_, controlnumber)};
+      return (high - low) / 2 + low + (high - low) % 2;
    }
 
    [[nodiscard]] int CenterPw() const noexcept
@@ -189,16 +299,29 @@ class ChannelModel {
              + (pitch_wheel_max_ - pitch_wheel_min_) % 2;
    }
 
-   // ReSharper disable once CppMemberFunctionMayBeStatic
-   [[nodiscard]] bool IsNrpn(int controlnumber) const
+   /* Curves are baked into a table per control, one entry per controller value (128, or 16384
+    * for NRPN controls) holding the value sent to Lightroom, so a curved control costs one read
+    * per message. Tables are built when the curve or range changes and are shared by controls
+    * with the same settings. Tables are never freed, as the dispatch and Lightroom input threads
+    * read them without a lock; reuse bounds them to the distinct curve and range settings made. */
+   struct CurveTable {
+      rsj::CurveSpec curve;
+      int low;
+      int high;
+      std::vector<double> values;
+   };
+
+   [[nodiscard]] const double* Table(rsj::Control controlnumber) const noexcept
    {
-      Expects(controlnumber <= kMaxNrpn && controlnumber >= 0);
-      return controlnumber > kMaxMidi;
+      return At(cc_table_, controlnumber).load(std::memory_order_acquire);
    }
 
-   double OffsetResult(int diff, int controlnumber, bool wrap);
+   double OffsetResult(int diff, rsj::Control controlnumber, bool wrap) noexcept;
    void ActiveToSaved() const;
-   void CcDefaults();
+   void BuildTable(rsj::Control controlnumber);
+   void CcDefaults() noexcept;
+   void KeepPosition(rsj::Control controlnumber, int old_low, int old_high) noexcept;
+   void SavedPositionsToActive();
    void SavedToActive();
    // ReSharper disable CppConstParameterInDeclaration
    template<class Archive> void load(Archive& archive, const uint32_t version);
@@ -206,12 +329,17 @@ class ChannelModel {
    // ReSharper restore CppConstParameterInDeclaration
 
    mutable std::vector<rsj::SettingsStruct> settings_to_save_ {};
+   mutable std::vector<rsj::ControlPosition> positions_to_save_ {};
+   mutable int pitch_wheel_to_save_ {kMaxNrpnHalf};
    int pitch_wheel_max_ {kMaxNrpn};
    int pitch_wheel_min_ {0};
    std::atomic<int> pitch_wheel_current_ {kMaxNrpnHalf};
    std::array<rsj::CCmethod, kMaxControls> cc_method_ {};
    std::array<int, kMaxControls> cc_high_ {};
    std::array<int, kMaxControls> cc_low_ {};
+   std::array<std::atomic<const double*>, kMaxControls> cc_table_ {}; /* null when linear */
+   std::map<int, rsj::CurveSpec> cc_curves_ {}; /* controls with a curve, by control number */
+   std::deque<CurveTable> curve_tables_ {}; /* deque: tables don't move as more are added */
 #ifdef __cpp_lib_atomic_ref
    std::array<int, kMaxControls> current_v_ {};
 #else
@@ -219,93 +347,105 @@ class ChannelModel {
 #endif
 };
 
+/* MIDI input (rsj::MidiMessage) was range-checked when the message was built, so those overloads
+ * index directly. Channel and control numbers given as int or in a MidiMessageId are checked
+ * once here, on the way in. */
 class ControlsModel {
  public:
    double ControllerToPlugin(rsj::MidiMessage mm, bool wrap)
    {
-      return all_controls_.at(mm.channel)
-          .ControllerToPlugin(mm.message_type_byte, mm.control_number, mm.value, wrap);
+      return Model(mm.GetChannel())
+          .ControllerToPlugin(mm.message_type_byte, mm.GetControl(), mm.value, wrap);
    }
 
    int MeasureChange(rsj::MidiMessage mm)
    {
-      return all_controls_.at(mm.channel)
-          .MeasureChange(mm.message_type_byte, mm.control_number, mm.value);
+      return Model(mm.GetChannel()).MeasureChange(mm.message_type_byte, mm.GetControl(), mm.value);
    }
 
    int SetToCenter(rsj::MidiMessageId mm)
    {
-      /* MidiMessageId channel is 1-based */
-      return all_controls_.at(gsl::narrow_cast<size_t>(mm.channel) - 1)
-          .SetToCenter(mm.msg_id_type, mm.control_number);
+      return Model(mm.GetChannel()).SetToCenter(mm.msg_id_type, mm.GetControl());
    }
 
    [[nodiscard]] rsj::CCmethod GetCcMethod(int channel, int controlnumber) const
    {
-      return all_controls_.at(channel).GetCcMethod(controlnumber);
+      return Model(rsj::Channel(channel)).GetCcMethod(rsj::Control(controlnumber));
    }
 
    [[nodiscard]] rsj::CCmethod GetCcMethod(rsj::MidiMessageId msg_id) const
    {
-      /* MidiMessageId channel is 1-based */
-      return all_controls_.at(gsl::narrow_cast<size_t>(msg_id.channel) - 1)
-          .GetCcMethod(msg_id.control_number);
+      return Model(msg_id.GetChannel()).GetCcMethod(msg_id.GetControl());
+   }
+
+   [[nodiscard]] rsj::CurveSpec GetCcCurve(int channel, int controlnumber) const
+   {
+      return Model(rsj::Channel(channel)).GetCcCurve(rsj::Control(controlnumber));
    }
 
    [[nodiscard]] int GetCcMax(int channel, int controlnumber) const
    {
-      return all_controls_.at(channel).GetCcMax(controlnumber);
+      return Model(rsj::Channel(channel)).GetCcMax(rsj::Control(controlnumber));
    }
 
    int GetCcMin(int channel, int controlnumber) const
    {
-      return all_controls_.at(channel).GetCcMin(controlnumber);
+      return Model(rsj::Channel(channel)).GetCcMin(rsj::Control(controlnumber));
    }
 
-   [[nodiscard]] int GetPwMax(int channel) const { return all_controls_.at(channel).GetPwMax(); }
+   [[nodiscard]] int GetPwMax(int channel) const { return Model(rsj::Channel(channel)).GetPwMax(); }
 
-   [[nodiscard]] int GetPwMin(int channel) const { return all_controls_.at(channel).GetPwMin(); }
+   [[nodiscard]] int GetPwMin(int channel) const { return Model(rsj::Channel(channel)).GetPwMin(); }
 
    int PluginToController(rsj::MidiMessageId msg_id, double value)
    {
-      /* msg_id is one-based */
-      return all_controls_.at(gsl::narrow_cast<size_t>(msg_id.channel) - 1)
-          .PluginToController(msg_id.msg_id_type, msg_id.control_number, value);
+      return Model(msg_id.GetChannel())
+          .PluginToController(msg_id.msg_id_type, msg_id.GetControl(), value);
    }
 
    int MeasureChange(rsj::MessageType controltype, int channel, int controlnumber, int value)
    {
-      return all_controls_.at(channel).MeasureChange(controltype, controlnumber, value);
+      return Model(rsj::Channel(channel))
+          .MeasureChange(controltype, rsj::Control(controlnumber), value);
    }
 
-   void SetCc(int channel, int controlnumber, int min, int max, rsj::CCmethod controltype)
+   void SetCc(int channel, int controlnumber, int min, int max, rsj::CCmethod controltype,
+       const rsj::CurveSpec& curve)
    {
-      all_controls_.at(channel).SetCc(controlnumber, min, max, controltype);
+      Model(rsj::Channel(channel))
+          .SetCc(rsj::Control(controlnumber), min, max, controltype, curve);
    }
 
-   void SetCcAll(int channel, int controlnumber, int min, int max, rsj::CCmethod controltype)
+   void SetCcAll(int channel, int controlnumber, int min, int max, rsj::CCmethod controltype,
+       const rsj::CurveSpec& curve)
    {
-      all_controls_.at(channel).SetCcAll(controlnumber, min, max, controltype);
+      Model(rsj::Channel(channel))
+          .SetCcAll(rsj::Control(controlnumber), min, max, controltype, curve);
+   }
+
+   void SetCcCurve(int channel, int controlnumber, const rsj::CurveSpec& curve)
+   {
+      Model(rsj::Channel(channel)).SetCcCurve(rsj::Control(controlnumber), curve);
    }
 
    void SetCcMax(int channel, int controlnumber, int value)
    {
-      all_controls_.at(channel).SetCcMax(controlnumber, value);
+      Model(rsj::Channel(channel)).SetCcMax(rsj::Control(controlnumber), value);
    }
 
    void SetCcMethod(int channel, int controlnumber, rsj::CCmethod value)
    {
-      all_controls_.at(channel).SetCcMethod(controlnumber, value);
+      Model(rsj::Channel(channel)).SetCcMethod(rsj::Control(controlnumber), value);
    }
 
    void SetCcMin(int channel, int controlnumber, int value)
    {
-      all_controls_.at(channel).SetCcMin(controlnumber, value);
+      Model(rsj::Channel(channel)).SetCcMin(rsj::Control(controlnumber), value);
    }
 
-   void SetPwMax(int channel, int value) { all_controls_.at(channel).SetPwMax(value); }
+   void SetPwMax(int channel, int value) { Model(rsj::Channel(channel)).SetPwMax(value); }
 
-   void SetPwMin(int channel, int value) { all_controls_.at(channel).SetPwMin(value); }
+   void SetPwMin(int channel, int value) { Model(rsj::Channel(channel)).SetPwMin(value); }
 
  private:
    friend class cereal::access;
@@ -321,7 +461,21 @@ class ControlsModel {
       }
    }
 
-   std::array<ChannelModel, 16> all_controls_;
+   [[nodiscard]] ChannelModel& Model(rsj::Channel channel) noexcept
+   {
+#pragma warning(suppress : 26446 26482) /* rsj::Channel is always in range */
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+      return all_controls_[channel.Index()];
+   }
+
+   [[nodiscard]] const ChannelModel& Model(rsj::Channel channel) const noexcept
+   {
+#pragma warning(suppress : 26446 26482) /* rsj::Channel is always in range */
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+      return all_controls_[channel.Index()];
+   }
+
+   std::array<ChannelModel, rsj::Channel::kCount> all_controls_;
 };
 
 template<class Archive> void ChannelModel::load(Archive& archive, const uint32_t version)
@@ -340,6 +494,14 @@ template<class Archive> void ChannelModel::load(Archive& archive, const uint32_t
              cereal::make_nvp("PWmin", pitch_wheel_min_));
          SavedToActive();
          break;
+      case 4:
+         archive(settings_to_save_, cereal::make_nvp("PWmax", pitch_wheel_max_),
+             cereal::make_nvp("PWmin", pitch_wheel_min_),
+             cereal::make_nvp("positions", positions_to_save_),
+             cereal::make_nvp("PWcurrent", pitch_wheel_to_save_));
+         SavedToActive();
+         SavedPositionsToActive();
+         break;
       default:
          {
             constexpr auto msg {
@@ -373,6 +535,13 @@ template<class Archive> void ChannelModel::save(Archive& archive, const uint32_t
          archive(settings_to_save_, cereal::make_nvp("PWmax", pitch_wheel_max_),
              cereal::make_nvp("PWmin", pitch_wheel_min_));
          break;
+      case 4:
+         ActiveToSaved();
+         archive(settings_to_save_, cereal::make_nvp("PWmax", pitch_wheel_max_),
+             cereal::make_nvp("PWmin", pitch_wheel_min_),
+             cereal::make_nvp("positions", positions_to_save_),
+             cereal::make_nvp("PWcurrent", pitch_wheel_to_save_));
+         break;
       default:
          {
             constexpr auto msg {
@@ -392,8 +561,9 @@ template<class Archive> void ChannelModel::save(Archive& archive, const uint32_t
 
 #pragma warning(push)
 #pragma warning(disable : 26426 26440 26444)
-CEREAL_CLASS_VERSION(ChannelModel, 3)
+CEREAL_CLASS_VERSION(ChannelModel, 4)
 CEREAL_CLASS_VERSION(ControlsModel, 1)
-CEREAL_CLASS_VERSION(rsj::SettingsStruct, 1)
+CEREAL_CLASS_VERSION(rsj::ControlPosition, 1)
+CEREAL_CLASS_VERSION(rsj::SettingsStruct, 2)
 #pragma warning(pop)
 #endif
@@ -0,0 +1,415 @@
+/*
+ * This file is part of MIDI2LR. Copyright (C) 2015 by Rory Jaffe.
+ *
+ * MIDI2LR is free software: you can redistribute it and/or modify it under the terms of the GNU
+ * General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * MIDI2LR is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with MIDI2LR.  If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "EventTap.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+#include <gsl/gsl>
+
+#include "Misc.h"
+
+namespace {
+   constexpr auto kDrainInterval {std::chrono::milliseconds(10)};
+   constexpr size_t kMaxBacklog {256 * 1024}; /* bytes queued for one connection */
+   constexpr size_t kTapPayload {54};         /* brings TapRecord to 64 bytes */
+
+   struct TapRecord {
+      int64_t time_ns;
+      rsj::TapKind kind;
+      uint8_t length;
+      std::array<char, kTapPayload> payload;
+   };
+
+   /* Bounded multi-producer queue after Dmitry Vyukov's: each slot's sequence number says whether
+    * it is free for the producer at that position or filled for the consumer. Producers claim a
+    * position with one compare-exchange and never wait; a full ring rejects the record. There is
+    * one consumer, the server's strand. */
+   class TapRing {
+    public:
+      TapRing() noexcept
+      {
+         for (size_t i {0}; i < kSlots; ++i) {
+#pragma warning(suppress : 26446 26482) /* loop bounds are array size */
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+         }
+      }
+
+      bool TryPush(const TapRecord& record) noexcept
+      {
+         auto pos {enqueue_pos_.load(std::memory_order_relaxed)};
+         for (;;) {
+            auto& slot {At(pos)};
+            const auto seq {slot.sequence.load(std::memory_order_acquire)};
+            if (seq == pos) {
+               if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                  slot.record = record;
+                  slot.sequence.store(pos + 1, std::memory_order_release);
+                  return true;
+               }
+            }
+            else if (seq < pos) { /* slot still holds the record from a lap ago */
+               dropped_.fetch_add(1, std::memory_order_relaxed);
+               return false;
+            }
+            else {
+               pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+         }
+      }
+
+      bool TryPop(TapRecord& record) noexcept
+      {
+         auto& slot {At(dequeue_pos_)};
+         if (slot.sequence.load(std::memory_order_acquire) != dequeue_pos_ + 1) { return false; }
+         record = slot.record;
+         slot.sequence.store(dequeue_pos_ + kSlots, std::memory_order_release);
+         ++dequeue_pos_;
+         return true;
+      }
+
+      [[nodiscard]] uint64_t dropped() const noexcept
+      {
+         return dropped_.load(std::memory_order_relaxed);
+      }
+
+    private:
+      static constexpr size_t kSlots {4096}; /* power of two */
+
+      struct Slot {
+         std::atomic<size_t> sequence;
+         TapRecord record;
+      };
+
+      [[nodiscard]] Slot& At(size_t pos) noexcept
+      {
+#pragma warning(suppress : 26446 26482) /* masked to array size */
+         // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+         return slots_[pos & (kSlots - 1)];
+      }
+
+      std::array<Slot, kSlots> slots_ {};
+      alignas(64) std::atomic<size_t> enqueue_pos_ {0};
+      alignas(64) size_t dequeue_pos_ {0};
+      std::atomic<uint64_t> dropped_ {0};
+   };
+
+   TapRing tap_ring {};
+
+   [[nodiscard]] TapRecord MakeRecord(rsj::TapKind kind) noexcept
+   {
+      TapRecord record; /* payload filled by caller up to length */
+      record.time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch())
+                           .count();
+      record.kind = kind;
+      record.length = 0;
+      return record;
+   }
+
+   /* returns the position after the bytes written */
+   char* PutLittleEndian(char* out, uint64_t value, const int bytes) noexcept
+   {
+      for (int i {0}; i < bytes; ++i) {
+         // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+         *out++ = static_cast<char>(value & 0xFFU);
+         value >>= 8U;
+      }
+      return out;
+   }
+
+   void AppendRecord(std::string& out, const TapRecord& record)
+   {
+      std::array<char, 8> time {};
+      PutLittleEndian(time.data(), static_cast<uint64_t>(record.time_ns), 8);
+      out.append(time.data(), time.size());
+      out.push_back(static_cast<char>(record.kind));
+      out.push_back(static_cast<char>(record.length));
+      out.append(record.payload.data(), record.length);
+   }
+} // namespace
+
+void rsj::TapMidiI(const TapKind kind, const MidiMessage mm) noexcept
+{
+   auto record {MakeRecord(kind)};
+   auto* out {record.payload.data()};
+   out = PutLittleEndian(out, static_cast<uint64_t>(mm.message_type_byte), 1);
+   out = PutLittleEndian(out, static_cast<uint64_t>(mm.GetChannel().Get()), 1);
+   out = PutLittleEndian(out, static_cast<uint32_t>(mm.GetControl().Get()), 2);
+   PutLittleEndian(out, static_cast<uint32_t>(mm.value), 4);
+   record.length = 8;
+   tap_ring.TryPush(record);
+}
+
+void rsj::TapTextI(const TapKind kind, std::string_view line) noexcept
+{
+   auto record {MakeRecord(kind)};
+   if (!line.empty() && line.back() == '\n') { line.remove_suffix(1); }
+   const auto length {std::min(line.size(), kTapPayload)};
+   std::copy_n(line.data(), length, record.payload.data());
+   record.length = gsl::narrow_cast<uint8_t>(length);
+   tap_ring.TryPush(record);
+}
+
+void rsj::TapValueI(
+    const TapKind kind, const std::string_view command, const double value) noexcept
+{
+   auto record {MakeRecord(kind)};
+   const auto result {fmt::format_to_n(record.payload.data(), kTapPayload, FMT_STRING("{} {}"),
+       command, value)};
+   record.length = gsl::narrow_cast<uint8_t>(std::min(result.size, kTapPayload));
+   tap_ring.TryPush(record);
+}
+
+class EventTapServerShared {
+ private:
+   friend EventTapServer;
+
+   struct Subscriber {
+      explicit Subscriber(asio::ip::tcp::socket&& sock) : socket {std::move(sock)} {}
+      asio::ip::tcp::socket socket;
+      std::string sending {};
+      std::string pending {};
+      std::array<char, 64> ignored {}; /* monitors have nothing to say, read to see them leave */
+      uint64_t dropped {0};
+      bool writing {false};
+   };
+
+   asio::strand<asio::io_context::executor_type> strand_;
+   asio::ip::tcp::acceptor acceptor_;
+   asio::steady_timer drain_timer_;
+   std::vector<std::shared_ptr<Subscriber>> subscribers_ {}; /* only touched on strand_ */
+   std::atomic<bool> thread_should_exit_ {false};
+   static void Accept(std::shared_ptr<EventTapServerShared> event_tap_server_shared);
+   static void Drain(std::shared_ptr<EventTapServerShared> event_tap_server_shared);
+   static void Watch(std::shared_ptr<EventTapServerShared> event_tap_server_shared,
+       std::shared_ptr<Subscriber> subscriber);
+   static void Write(std::shared_ptr<EventTapServerShared> event_tap_server_shared,
+       std::shared_ptr<Subscriber> subscriber);
+   void Remove(const std::shared_ptr<Subscriber>& subscriber);
+
+ public:
+   explicit EventTapServerShared(asio::io_context& io_context)
+       : strand_ {asio::make_strand(io_context)}, acceptor_ {strand_}, drain_timer_ {strand_}
+   {
+   }
+};
+
+EventTapServer::EventTapServer(asio::io_context& io_context)
+    : event_tap_server_shared_ {std::make_shared<EventTapServerShared>(io_context)}
+{
+}
+
+void EventTapServer::Start(const int port)
+{
+   try {
+      if (port <= 0 || port > 0xFFFF) { return; }
+      auto& acceptor {event_tap_server_shared_->acceptor_};
+      const asio::ip::tcp::endpoint endpoint {asio::ip::address_v4::loopback(),
+          gsl::narrow_cast<asio::ip::port_type>(port)};
+      asio::error_code ec;
+      acceptor.open(endpoint.protocol(), ec);
+      if (!ec) { acceptor.set_option(asio::ip::tcp::acceptor::reuse_address(true), ec); }
+      if (!ec) { acceptor.bind(endpoint, ec); }
+      if (!ec) { acceptor.listen(asio::socket_base::max_listen_connections, ec); }
+      if (ec) {
+         rsj::Log(fmt::format(FMT_STRING("EventTapServer couldn't listen on TCP port {}. {}."),
+             port, ec.message()));
+         asio::error_code ec2;
+         acceptor.close(ec2);
+         return;
+      }
+      EventTapServerShared::Accept(event_tap_server_shared_);
+   }
+   catch (const std::exception& e) {
+      MIDI2LR_E_RESPONSE;
+      throw;
+   }
+}
+
+void EventTapServer::Stop()
+{
+   try {
+      rsj::tap_subscribers.store(0, std::memory_order_relaxed);
+      auto& shared {*event_tap_server_shared_};
+      shared.thread_should_exit_.store(true, std::memory_order_release);
+      asio::post(shared.strand_, [event_tap_server_shared = event_tap_server_shared_] {
+         auto& sh {*event_tap_server_shared};
+         asio::error_code ec;
+         sh.acceptor_.close(ec);
+         sh.drain_timer_.cancel();
+         for (const auto& subscriber : sh.subscribers_) { subscriber->socket.close(ec); }
+         sh.subscribers_.clear();
+      });
+   }
+   catch (const std::exception& e) {
+      MIDI2LR_E_RESPONSE;
+      throw;
+   }
+}
+
+void EventTapServerShared::Accept(std::shared_ptr<EventTapServerShared> event_tap_server_shared)
+{
+   try {
+      if (event_tap_server_shared->thread_should_exit_.load(std::memory_order_acquire)) { return; }
+      auto& shared {*event_tap_server_shared};
+      shared.acceptor_.async_accept(shared.strand_,
+          [event_tap_server_shared](const asio::error_code& error,
+              asio::ip::tcp::socket socket) mutable {
+             auto& sh {*event_tap_server_shared};
+             if (sh.thread_should_exit_.load(std::memory_order_acquire)
+                 || error == asio::error::operation_aborted) {
+                return;
+             }
+             if (!error) [[likely]] {
+                asio::error_code ec;
+                socket.set_option(asio::ip::tcp::no_delay(true), ec);
+                const auto first {sh.subscribers_.empty()};
+                if (first) { /* discard whatever was tapped for the last subscriber */
+                   TapRecord stale;
+                   while (tap_ring.TryPop(stale)) {}
+                }
+                auto subscriber {std::make_shared<Subscriber>(std::move(socket))};
+                sh.subscribers_.push_back(subscriber);
+                rsj::tap_subscribers.store(gsl::narrow_cast<int>(sh.subscribers_.size()),
+                    std::memory_order_relaxed);
+                rsj::Log(fmt::format(FMT_STRING("EventTapServer: monitor connected, {} now."),
+                    sh.subscribers_.size()));
+                Watch(event_tap_server_shared, std::move(subscriber));
+                if (first) { Drain(event_tap_server_shared); }
+             }
+             else {
+                rsj::Log(fmt::format(FMT_STRING("EventTapServer accept error: {}."),
+                    error.message()));
+             }
+             Accept(std::move(event_tap_server_shared));
+          });
+   }
+   catch (const std::exception& e) {
+      MIDI2LR_E_RESPONSE_F;
+      throw;
+   }
+}
+
+void EventTapServerShared::Drain(std::shared_ptr<EventTapServerShared> event_tap_server_shared)
+{
+   try {
+      auto& shared {*event_tap_server_shared};
+      if (shared.thread_should_exit_.load(std::memory_order_acquire)
+          || shared.subscribers_.empty()) {
+         return;
+      }
+      std::string batch;
+      uint64_t records {0};
+      for (TapRecord record; tap_ring.TryPop(record); ++records) { AppendRecord(batch, record); }
+      if (records != 0) {
+         for (const auto& subscriber : shared.subscribers_) {
+            if (subscriber->pending.size() + batch.size() > kMaxBacklog) {
+               subscriber->dropped += records; /* not keeping up; don't queue without bound */
+               continue;
+            }
+            subscriber->pending += batch;
+            if (!subscriber->writing) { Write(event_tap_server_shared, subscriber); }
+         }
+      }
+      shared.drain_timer_.expires_after(kDrainInterval);
+      shared.drain_timer_.async_wait(
+          [event_tap_server_shared](const asio::error_code& error) mutable {
+             if (!error) { Drain(std::move(event_tap_server_shared)); }
+          });
+   }
+   catch (const std::exception& e) {
+      MIDI2LR_E_RESPONSE_F;
+      throw;
+   }
+}
+
+void EventTapServerShared::Watch(std::shared_ptr<EventTapServerShared> event_tap_server_shared,
+    std::shared_ptr<Subscriber> subscriber)
+{
+   try {
+      auto& sub {*subscriber};
+      sub.socket.async_read_some(asio::buffer(sub.ignored),
+          [event_tap_server_shared, subscriber](const asio::error_code& error,
+              std::size_t) mutable {
+             if (event_tap_server_shared->thread_should_exit_.load(std::memory_order_acquire)
+                 || error == asio::error::operation_aborted) {
+                return;
+             }
+             if (error) { event_tap_server_shared->Remove(subscriber); }
+             else { Watch(std::move(event_tap_server_shared), std::move(subscriber)); }
+          });
+   }
+   catch (const std::exception& e) {
+      MIDI2LR_E_RESPONSE_F;
+      throw;
+   }
+}
+
+void EventTapServerShared::Write(std::shared_ptr<EventTapServerShared> event_tap_server_shared,
+    std::shared_ptr<Subscriber> subscriber)
+{
+   try {
+      auto& sub {*subscriber};
+      sub.sending.swap(sub.pending);
+      sub.pending.clear();
+      sub.writing = true;
+      /* completion runs on strand_, the socket's executor */
+      asio::async_write(sub.socket, asio::buffer(sub.sending),
+          [event_tap_server_shared, subscriber](const asio::error_code& error,
+              std::size_t) mutable {
+             subscriber->writing = false;
+             if (event_tap_server_shared->thread_should_exit_.load(std::memory_order_acquire)
+                 || error == asio::error::operation_aborted) {
+                return;
+             }
+             if (error) { event_tap_server_shared->Remove(subscriber); }
+             else if (!subscriber->pending.empty()) {
+                Write(std::move(event_tap_server_shared), std::move(subscriber));
+             }
+          });
+   }
+   catch (const std::exception& e) {
+      MIDI2LR_E_RESPONSE_F;
+      throw;
+   }
+}
+
+void EventTapServerShared::Remove(const std::shared_ptr<Subscriber>& subscriber)
+{
+   try {
+      if (std::erase(subscribers_, subscriber) == 0) { return; } /* read and write both failed */
+      rsj::tap_subscribers.store(gsl::narrow_cast<int>(subscribers_.size()),
+          std::memory_order_relaxed);
+      asio::error_code ec;
+      subscriber->socket.close(ec);
+      rsj::Log(fmt::format(FMT_STRING("EventTapServer: monitor disconnected, {} records dropped "
+                                      "for it, {} dropped by a full ring since start."),
+          subscriber->dropped, tap_ring.dropped()));
+   }
+   catch (const std::exception& e) {
+      MIDI2LR_E_RESPONSE;
+      throw;
+   }
+}
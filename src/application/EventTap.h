@@ -0,0 +1,97 @@
+#ifndef MIDI2LR_EVENTTAP_H_INCLUDED
+#define MIDI2LR_EVENTTAP_H_INCLUDED
+/*
+ * This file is part of MIDI2LR. Copyright (C) 2015 by Rory Jaffe.
+ *
+ * MIDI2LR is free software: you can redistribute it and/or modify it under the terms of the GNU
+ * General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * MIDI2LR is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with MIDI2LR.  If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+#include <asio/asio.hpp>
+
+#include "MidiUtilities.h"
+
+/*****************************************************************************/
+/*************Tap points******************************************************/
+/*****************************************************************************/
+/* Copies events at the stages below to monitoring tools connected to EventTapServer. Tap calls are
+ * made on the pipeline threads; while nobody is connected each costs one relaxed atomic load. While
+ * someone is, the event goes into a lock-free ring and the call returns; if the ring is full the
+ * event is dropped, never waited on. */
+namespace rsj {
+   enum class TapKind : uint8_t {
+      kMidiIn = 1,    /* MIDI message after the pipeline, as passed to the callbacks */
+      kOscIn,         /* OSC message, as passed to the callbacks */
+      kToLightroom,   /* line written to the plugin */
+      kCoalesced,     /* value replaced a queued one for the same command */
+      kSameStep,      /* value dropped, same Lightroom step as the last one queued */
+      kFromLightroom, /* line received from the plugin */
+   };
+
+   inline std::atomic<int> tap_subscribers {0};
+   void TapMidiI(TapKind kind, MidiMessage mm) noexcept;
+   void TapTextI(TapKind kind, std::string_view line) noexcept;
+   void TapValueI(TapKind kind, std::string_view command, double value) noexcept;
+
+   inline void Tap(TapKind kind, MidiMessage mm) noexcept
+   {
+      if (tap_subscribers.load(std::memory_order_relaxed) != 0) [[unlikely]] {
+         TapMidiI(kind, mm);
+      }
+   }
+
+   inline void Tap(TapKind kind, std::string_view line) noexcept
+   {
+      if (tap_subscribers.load(std::memory_order_relaxed) != 0) [[unlikely]] {
+         TapTextI(kind, line);
+      }
+   }
+
+   inline void Tap(TapKind kind, std::string_view command, double value) noexcept
+   {
+      if (tap_subscribers.load(std::memory_order_relaxed) != 0) [[unlikely]] {
+         TapValueI(kind, command, value);
+      }
+   }
+} // namespace rsj
+
+/*****************************************************************************/
+/*************EventTapServer**************************************************/
+/*****************************************************************************/
+class EventTapServerShared;
+
+/* Accepts monitoring connections on a loopback TCP port and streams tapped events to each, as
+ * records of: 8 byte steady clock time in nanoseconds, 1 byte TapKind, 1 byte payload length, then
+ * the payload, all little-endian. MIDI payloads are 8 bytes: message type, channel (0-15), 2 byte
+ * control number, 4 byte value. Text payloads are the line, without its newline, truncated to 54
+ * bytes. A connection that doesn't keep up loses records rather than slowing the pipeline. */
+class EventTapServer {
+ public:
+   explicit EventTapServer(asio::io_context& io_context);
+   ~EventTapServer() = default;
+   EventTapServer(const EventTapServer& other) = delete;
+   EventTapServer(EventTapServer&& other) = delete;
+   EventTapServer& operator=(const EventTapServer& other) = delete;
+   EventTapServer& operator=(EventTapServer&& other) = delete;
+   /* port 0 leaves the tap off. Any program on this computer can connect */
+   void Start(int port);
+   void Stop();
+
+ private:
+   std::shared_ptr<EventTapServerShared> event_tap_server_shared_;
+};
+
+#endif
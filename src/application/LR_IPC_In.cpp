@@ -17,11 +17,14 @@
 
 #include <algorithm>
 #include <atomic>
+#include <deque>
 #include <exception>
+#include <sstream>
 #include <string>
 #include <string_view> //ReSharper false alarm
 #include <thread>
 #include <utility>
+#include <vector>
 
 #include <fmt/format.h>
 #include <gsl/gsl>
@@ -31,11 +34,14 @@
 
 #include "Concurrency.h"
 #include "ControlsModel.h"
+#include "EventTap.h"
+#include "LR_IPC_Out.h"
 #include "MIDISender.h"
 #include "MidiUtilities.h"
 #include "Misc.h"
 #include "Profile.h"
 #include "ProfileManager.h"
+#include "ProfiledMutex.h"
 #include "SendKeys.h"
 
 using namespace std::literals::chrono_literals;
@@ -43,8 +49,8 @@ using namespace std::string_literals;
 
 namespace {
    constexpr auto kEmptyWait {100ms};
+   constexpr size_t kLineCapacity {1024}; /* lines waiting to be processed before reads pause */
    constexpr auto kLrInPort {58764};
-   constexpr auto kTerminate {"MBxegp3VXilFy0"};
 } // namespace
 
 class LrIpcInShared {
@@ -52,18 +58,24 @@ class LrIpcInShared {
    friend LrIpcIn;
    asio::ip::tcp::socket socket_;
    asio::streambuf streambuf_ {};
-   rsj::ConcurrentQueue<std::string> line_;
+   rsj::ConcurrentQueue<std::string, std::deque<std::string>,
+       rsj::ProfiledMutex<"LrIpcIn lines">>
+       line_;
+   std::atomic<bool> read_paused_ {false};
    std::atomic<bool> thread_should_exit_ {false};
    static void Read(std::shared_ptr<LrIpcInShared> lr_ipc_shared);
+   static void ResumeRead(const std::shared_ptr<LrIpcInShared>& lr_ipc_shared);
 
  public:
-   explicit LrIpcInShared(asio::io_context& io_context) : socket_ {asio::make_strand(io_context)} {}
+   explicit LrIpcInShared(asio::io_context& io_context) : socket_ {asio::make_strand(io_context)}
+   {
+   }
 };
 
 LrIpcIn::LrIpcIn(ControlsModel& c_model, ProfileManager& profile_manager, const Profile& profile,
-    const MidiSender& midi_sender, asio::io_context& io_context)
+    const MidiSender& midi_sender, LrIpcOut& lr_ipc_out, asio::io_context& io_context)
     : midi_sender_ {midi_sender}, profile_ {profile}, controls_model_ {c_model},
-      profile_manager_ {profile_manager},
+      lr_ipc_out_ {lr_ipc_out}, profile_manager_ {profile_manager},
       lr_ipc_in_shared_ {std::make_shared<LrIpcInShared>(io_context)}
 {
 }
@@ -103,10 +115,11 @@ void LrIpcIn::Stop()
             rsj::Log(fmt::format(FMT_STRING("LR_IPC_In socket close error {}."), ec.message()));
          }
       }
-      /* clear input queue after port closed */
-      if (const auto m {lr_ipc_in_shared_->line_.clear_count_emplace(kTerminate)}) {
+      /* clear input queue after port closed, then end ProcessLine */
+      if (const auto m {lr_ipc_in_shared_->line_.clear_count()}) {
          rsj::Log(fmt::format(FMT_STRING("{} left in queue in LrIpcIn destructor."), m));
       }
+      lr_ipc_in_shared_->line_.close();
    }
    catch (const std::exception& e) {
       MIDI2LR_E_RESPONSE;
@@ -155,52 +168,77 @@ namespace {
 void LrIpcIn::ProcessLine(std::shared_ptr<LrIpcInShared> lr_ipc_shared)
 {
    try {
-      for (auto line_copy = lr_ipc_shared->line_.pop(); line_copy != kTerminate;
-           line_copy = lr_ipc_shared->line_.pop()) {
-         auto [command_view, value_view] {SplitLine(line_copy)};
-         const auto command {std::string(command_view)};
-         if (command == "TerminateApplication"s) {
-            juce::JUCEApplication::getInstance()->systemRequestedQuit();
-            return;
-         }
-         if (value_view.empty()) {
-            rsj::Log(fmt::format(FMT_STRING("No value attached to message. Message from plugin was "
-                                            "\"{}\"."),
-                rsj::ReplaceInvisibleChars(line_copy)));
-         }
-         else if (command == "SwitchProfile"s) {
-            profile_manager_.SwitchToProfile(std::string(value_view));
-         }
-         else if (command == "Log"s) {
-            rsj::Log(fmt::format(FMT_STRING("Plugin: {}."), value_view));
-         }
-         else if (command == "SendKey"s) {
-            const auto modifiers {std::stoi(std::string(value_view))};
-            /* trim twice on purpose: first modifiers digits, then one space (fixed delimiter) */
-            const auto first_not_digit {value_view.find_first_not_of("0123456789")};
-            if (first_not_digit != std::string_view::npos) {
-               value_view.remove_prefix(first_not_digit + 1);
-               if (!value_view.empty()) {
-                  rsj::SendKeyDownUp(std::string(value_view),
-                      rsj::ActiveModifiers::FromMidi2LR(modifiers));
-                  continue; /* skip log and alert error */
+      std::deque<std::string> lines; /* one lock per burst from the plugin */
+      while (lr_ipc_shared->line_.pop_all(lines)) {
+         LrIpcInShared::ResumeRead(lr_ipc_shared);
+         for (const auto& line_copy : lines) {
+            rsj::Tap(rsj::TapKind::kFromLightroom, line_copy);
+            auto [command_view, value_view] {SplitLine(line_copy)};
+            const auto command {std::string(command_view)};
+            if (command == "TerminateApplication"s) {
+               juce::JUCEApplication::getInstance()->systemRequestedQuit();
+               return;
+            }
+            if (command == "LockReport"s) {
+               rsj::LogLockContention();
+               continue;
+            }
+            if (value_view.empty()) {
+               rsj::Log(fmt::format(FMT_STRING("No value attached to message. Message from plugin "
+                                               "was \"{}\"."),
+                   rsj::ReplaceInvisibleChars(line_copy)));
+            }
+            else if (command == "SwitchProfile"s) {
+               profile_manager_.SwitchToProfile(std::string(value_view));
+            }
+            else if (command == "ParamRange"s) { /* parameter min max step */
+               std::istringstream range {std::string(value_view)};
+               std::string param;
+               double min {};
+               double max {};
+               double step {};
+               if (range >> param >> min >> max >> step && max > min && step > 0.0) {
+                  lr_ipc_out_.SetParameterRange(param, min, max, step);
+               }
+               else {
+                  rsj::Log(fmt::format(FMT_STRING("Unable to parse parameter range. Message from "
+                                                  "plugin was \"{}\"."),
+                      rsj::ReplaceInvisibleChars(line_copy)));
                }
             }
-            rsj::LogAndAlertError(fmt::format(FMT_STRING("SendKey couldn't identify keystroke. "
-                                                         "Message from plugin was \"{}\"."),
-                rsj::ReplaceInvisibleChars(line_copy)));
-         }
-         else { /* send associated messages to MIDI OUT devices */
-            const auto original_value {std::stod(std::string(value_view))};
-            for (const auto& msg : profile_.GetMessagesForCommand(command)) {
-               /* following needs to run for all controls: sets saved value */
-               const auto value {controls_model_.PluginToController(msg, original_value)};
-               if (msg.msg_id_type != rsj::MessageType::kCc
-                   || controls_model_.GetCcMethod(msg) == rsj::CCmethod::kAbsolute) {
-                  midi_sender_.Send(msg, value);
+            else if (command == "Log"s) {
+               rsj::Log(fmt::format(FMT_STRING("Plugin: {}."), value_view));
+            }
+            else if (command == "SendKey"s) {
+               const auto modifiers {std::stoi(std::string(value_view))};
+               /* trim twice on purpose: first modifiers digits, then one space (fixed delimiter) */
+               const auto first_not_digit {value_view.find_first_not_of("0123456789")};
+               if (first_not_digit != std::string_view::npos) {
+                  value_view.remove_prefix(first_not_digit + 1);
+                  if (!value_view.empty()) {
+                     rsj::SendKeyDownUp(std::string(value_view),
+                         rsj::ActiveModifiers::FromMidi2LR(modifiers));
+                     continue; /* skip log and alert error */
+                  }
+               }
+               rsj::LogAndAlertError(fmt::format(FMT_STRING("SendKey couldn't identify keystroke. "
+                                                            "Message from plugin was \"{}\"."),
+                   rsj::ReplaceInvisibleChars(line_copy)));
+            }
+            else { /* send associated messages to MIDI OUT devices */
+               const auto original_value {std::stod(std::string(value_view))};
+               lr_ipc_out_.ForgetSentValue(command, original_value);
+               for (const auto& msg : profile_.GetMessagesForCommand(command)) {
+                  /* following needs to run for all controls: sets saved value */
+                  const auto value {controls_model_.PluginToController(msg, original_value)};
+                  if (msg.msg_id_type != rsj::MessageType::kCc
+                      || controls_model_.GetCcMethod(msg) == rsj::CCmethod::kAbsolute) {
+                     midi_sender_.Send(msg, value);
+                  }
                }
             }
          }
+         lines.clear();
       }
    }
    catch (const std::exception& e) {
@@ -209,6 +247,22 @@ void LrIpcIn::ProcessLine(std::shared_ptr<LrIpcInShared> lr_ipc_shared)
    }
 }
 
+/* called by ProcessLine each time it takes the queued lines: restarts reading if the socket
+ * reader paused on a full queue */
+void LrIpcInShared::ResumeRead(const std::shared_ptr<LrIpcInShared>& lr_ipc_shared)
+{
+   try {
+      if (lr_ipc_shared->read_paused_.exchange(false)) {
+         asio::post(lr_ipc_shared->socket_.get_executor(),
+             [lr_ipc_shared]() mutable { Read(std::move(lr_ipc_shared)); });
+      }
+   }
+   catch (const std::exception& e) {
+      MIDI2LR_E_RESPONSE_F;
+      throw;
+   }
+}
+
 void LrIpcInShared::Read(std::shared_ptr<LrIpcInShared> lr_ipc_shared)
 {
    try {
@@ -219,14 +273,34 @@ void LrIpcInShared::Read(std::shared_ptr<LrIpcInShared> lr_ipc_shared)
             if (!error) [[likely]] {
                if (bytes_transferred == 0) [[unlikely]] { std::this_thread::sleep_for(kEmptyWait); }
                else {
+                  /* the plugin batches lines, so the buffer usually holds many complete lines past
+                   * the first one. Queue all of them at once, leaving any partial line */
                   auto& buf {lr_ipc_shared->streambuf_};
-                  std::string command {buffers_begin(buf.data()),
-                      buffers_begin(buf.data()) + gsl::narrow<std::ptrdiff_t>(bytes_transferred)};
-                  if (command == "TerminateApplication 1\n"s) {
-                     lr_ipc_shared->thread_should_exit_.store(true, std::memory_order_release);
+                  const std::string_view received {
+                      static_cast<const char*>(buf.data().data()), buf.size()};
+                  const auto complete {received.substr(0, received.rfind('\n') + 1)};
+                  std::vector<std::string> lines;
+                  for (auto rest {complete}; !rest.empty();) {
+                     const auto line_end {rest.find('\n') + 1};
+                     lines.emplace_back(rest.substr(0, line_end));
+                     rest.remove_prefix(line_end);
+                     if (lines.back() == "TerminateApplication 1\n"s) {
+                        lr_ipc_shared->thread_should_exit_.store(true, std::memory_order_release);
+                     }
+                  }
+                  lr_ipc_shared->line_.push_range(std::move(lines));
+                  buf.consume(complete.size());
+                  /* Lines can't be dropped and an io thread mustn't wait, so when the queue is
+                   * full the next read isn't started until ProcessLine empties it. The plugin
+                   * then waits on TCP flow control. The recheck covers ProcessLine emptying the
+                   * queue before the pause was seen */
+                  if (lr_ipc_shared->line_.size() >= kLineCapacity) {
+                     lr_ipc_shared->read_paused_.store(true);
+                     if (lr_ipc_shared->line_.size() >= kLineCapacity
+                         || !lr_ipc_shared->read_paused_.exchange(false)) {
+                        return;
+                     }
                   }
-                  lr_ipc_shared->line_.push(std::move(command));
-                  buf.consume(bytes_transferred);
                }
                Read(std::move(lr_ipc_shared));
             }
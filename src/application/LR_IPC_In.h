@@ -23,6 +23,7 @@
 
 class ControlsModel;
 class LrIpcInShared;
+class LrIpcOut;
 class MidiSender;
 class Profile;
 class ProfileManager;
@@ -30,7 +31,7 @@ class ProfileManager;
 class LrIpcIn {
  public:
    LrIpcIn(ControlsModel& c_model, ProfileManager& profile_manager, const Profile& profile,
-       const MidiSender& midi_sender, asio::io_context& io_context);
+       const MidiSender& midi_sender, LrIpcOut& lr_ipc_out, asio::io_context& io_context);
    ~LrIpcIn() = default;
    LrIpcIn(const LrIpcIn& other) = delete;
    LrIpcIn(LrIpcIn&& other) = delete;
@@ -46,6 +47,7 @@ class LrIpcIn {
    const MidiSender& midi_sender_;
    const Profile& profile_;
    ControlsModel& controls_model_;
+   LrIpcOut& lr_ipc_out_;
    ProfileManager& profile_manager_;
    std::future<void> process_line_future_;
    std::shared_ptr<LrIpcInShared> lr_ipc_in_shared_;
@@ -17,18 +17,27 @@
 
 #include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
 #include <exception>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #include <dry-comparisons/dry-comparisons.hpp>
 #include <fmt/format.h>
 
 #include "CommandSet.h"
-#include "Concurrency.h"
 #include "ControlsModel.h"
+#include "EventTap.h"
 #include "MIDIReceiver.h"
 #include "MIDISender.h"
 #include "Misc.h"
 #include "Profile.h"
+#include "ProfiledMutex.h"
 
 using Clock = std::chrono::steady_clock;
 using TimePoint = Clock::time_point;
@@ -40,13 +49,124 @@ namespace {
    constexpr auto kMinRecenterTime {250ms}; /* minimum period before recentering */
    constexpr auto kRecenterTimer {std::max(kMinRecenterTime, kDelay + kDelay / 2)};
    constexpr auto kTerminate {"!!!@#$%^"};
+
+   /* Commands to Lightroom, in the order they were queued. Discrete commands (buttons, relative
+    * steps, messages from the app) are queued as they come. Continuous values are coalesced per
+    * command: a new value replaces one for that command queued since the last discrete command,
+    * so a tap waits behind about one value per moving control, not a fader sweep. A value is
+    * never moved past a discrete command, so a queued value can't land on the next photo or undo a
+    * reset. Button commands are always discrete, whatever the control they are mapped to. For
+    * parameters whose Lightroom range and step are known, a value that rounds to the same
+    * Lightroom value as the last one queued is dropped. */
+   class CommandQueue {
+    public:
+      void PushDiscrete(std::string&& command)
+      {
+         {
+            auto lock {std::scoped_lock(mutex_)};
+            queue_.push_back({std::move(command), std::nullopt});
+         }
+         condition_.notify_one();
+      }
+
+      void PushValue(const std::string& command, double value)
+      {
+         {
+            auto lock {std::scoped_lock(mutex_)};
+            if (const auto range {ranges_.find(command)}; range != ranges_.end()) {
+               auto& r {range->second};
+               const auto steps {r.Steps(value)};
+               if (r.last_steps == steps) {
+                  rsj::Tap(rsj::TapKind::kSameStep, command, value);
+                  return;
+               }
+               r.last_steps = steps;
+            }
+            /* only values queued since the last discrete command */
+            for (auto it {queue_.rbegin()}; it != queue_.rend() && it->value; ++it) {
+               if (it->command == command) {
+                  it->value = value;
+                  rsj::Tap(rsj::TapKind::kCoalesced, command, value);
+                  return;
+               }
+            }
+            queue_.push_back({command, value});
+         }
+         condition_.notify_one();
+      }
+
+      /* blocks until a command is available */
+      [[nodiscard]] std::string pop()
+      {
+         auto lock {std::unique_lock(mutex_)};
+         condition_.wait(lock, [this] { return !queue_.empty(); });
+         auto pending {std::move(queue_.front())};
+         queue_.pop_front();
+         lock.unlock();
+         if (!pending.value) { return std::move(pending.command); }
+         return fmt::format(FMT_STRING("{} {}\n"), pending.command, *pending.value);
+      }
+
+      void SetRange(const std::string& command, double min, double max, double step)
+      {
+         auto lock {std::scoped_lock(mutex_)};
+         ranges_.insert_or_assign(command, Range {min, max, step, std::nullopt});
+      }
+
+      /* keeps the last step when value is Lightroom echoing it back */
+      void ForgetLast(const std::string& command, double value)
+      {
+         auto lock {std::scoped_lock(mutex_)};
+         if (const auto range {ranges_.find(command)}; range != ranges_.end()) {
+            auto& r {range->second};
+            if (r.last_steps != r.Steps(value)) { r.last_steps.reset(); }
+         }
+      }
+
+      /* empties the queue, then queues command; returns the number of commands discarded */
+      size_t clear_count_push(std::string&& command)
+      {
+         size_t count {0};
+         {
+            auto lock {std::scoped_lock(mutex_)};
+            count = queue_.size();
+            queue_.clear();
+            queue_.push_back({std::move(command), std::nullopt});
+         }
+         condition_.notify_one();
+         return count;
+      }
+
+    private:
+      struct Pending {
+         std::string command;         /* the whole line when discrete */
+         std::optional<double> value; /* empty when discrete */
+      };
+
+      struct Range {
+         double min;
+         double max;
+         double step;
+         std::optional<long long> last_steps; /* last queued value, in steps */
+
+         [[nodiscard]] long long Steps(double value) const
+         {
+            return std::llround((value * (max - min) + min) / step);
+         }
+      };
+
+      std::condition_variable_any condition_;
+      std::deque<Pending> queue_;
+      rsj::ProfiledMutex<"LrIpcOut command queue"> mutex_;
+      std::unordered_map<std::string, Range> ranges_;
+   };
 } // namespace
 
 class LrIpcOutShared {
  private:
    friend LrIpcOut;
    asio::ip::tcp::socket socket_;
-   rsj::ConcurrentQueue<std::string> command_;
+   CommandQueue command_;
    static void SendOut(std::shared_ptr<LrIpcOutShared> lr_ipc_out_shared);
 
  public:
@@ -59,19 +179,76 @@ LrIpcOut::LrIpcOut(const CommandSet& command_set, ControlsModel& c_model, const
     const MidiSender& midi_sender, MidiReceiver& midi_receiver, asio::io_context& io_context)
     : recenter_timer_ {asio::make_strand(io_context)}, midi_sender_ {midi_sender},
       profile_ {profile}, repeat_cmd_ {command_set.GetRepeats()}, wrap_ {command_set.GetWraps()},
-      controls_model_ {c_model}, lr_ipc_out_shared_ {std::make_shared<LrIpcOutShared>(io_context)}
+      buttons_ {command_set.GetButtons()}, controls_model_ {c_model},
+      lr_ipc_out_shared_ {std::make_shared<LrIpcOutShared>(io_context)}
 {
    midi_receiver.AddCallback(this, &LrIpcOut::MidiCmdCallback);
 }
 
 void LrIpcOut::SendCommand(std::string&& command)
 {
-   if (!sending_stopped_) { lr_ipc_out_shared_->command_.push(std::move(command)); }
+   if (!sending_stopped_) {
+      SendSubscriptions();
+      lr_ipc_out_shared_->command_.PushDiscrete(std::move(command));
+   }
 }
 
 void LrIpcOut::SendCommand(const std::string& command)
 {
-   if (!sending_stopped_) { lr_ipc_out_shared_->command_.push(command); }
+   if (!sending_stopped_) {
+      SendSubscriptions();
+      lr_ipc_out_shared_->command_.PushDiscrete(std::string(command));
+   }
+}
+
+/* Tells the plugin which commands the profile maps, ahead of the first command sent after the
+ * profile changes or the connection is made. The plugin's change observer only reads and sends
+ * back those parameters. */
+void LrIpcOut::SendSubscriptions()
+{
+   try {
+      if (subscribed_version_.load(std::memory_order_acquire) == profile_.Version()) { return; }
+      auto [version, rows] {profile_.Snapshot()};
+      if (subscribed_version_.exchange(version, std::memory_order_acq_rel) == version) { return; }
+      std::vector<std::string> commands;
+      commands.reserve(rows.size());
+      for (auto& row : rows) {
+         if (row.second != CommandSet::kUnassigned) { commands.push_back(std::move(row.second)); }
+      }
+      std::ranges::sort(commands);
+      const auto [first, last] {std::ranges::unique(commands)};
+      commands.erase(first, last);
+      std::string line {"Subscribe "};
+      for (const auto& command : commands) {
+         if (line.back() != ' ') { line += ','; }
+         line += command;
+      }
+      line += '\n';
+      lr_ipc_out_shared_->command_.PushDiscrete(std::move(line));
+   }
+   catch (const std::exception& e) {
+      MIDI2LR_E_RESPONSE;
+      throw;
+   }
+}
+
+void LrIpcOut::SendValue(const std::string& command, double value)
+{
+   if (!sending_stopped_) {
+      SendSubscriptions();
+      lr_ipc_out_shared_->command_.PushValue(command, value);
+   }
+}
+
+void LrIpcOut::SetParameterRange(const std::string& command, const double min, const double max,
+    const double step)
+{
+   lr_ipc_out_shared_->command_.SetRange(command, min, max, step);
+}
+
+void LrIpcOut::ForgetSentValue(const std::string& command, const double value)
+{
+   lr_ipc_out_shared_->command_.ForgetLast(command, value);
 }
 
 void LrIpcOut::SendingRestart()
@@ -107,7 +284,7 @@ void LrIpcOut::Stop()
 {
    thread_should_exit_.store(true, std::memory_order_release);
    /* clear output queue before port closed */
-   if (const auto m {lr_ipc_out_shared_->command_.clear_count_emplace(kTerminate)}) {
+   if (const auto m {lr_ipc_out_shared_->command_.clear_count_push(kTerminate)}) {
       rsj::Log(fmt::format(FMT_STRING("{} left in queue in LrIpcOut destructor."), m));
    }
    {
@@ -166,6 +343,7 @@ void LrIpcOut::ConnectionMade()
          connected_ = true;
          for (const auto& cb : callbacks_) { cb(true, sending_stopped_); }
       }
+      subscribed_version_.store(UINT64_MAX, std::memory_order_release); /* plugin may be new */
       rsj::Log("Socket connected in LR_IPC_Out.");
    }
    catch (const std::exception& e) {
@@ -184,7 +362,7 @@ void LrIpcOut::MidiCmdCallback(rsj::MidiMessage mm)
              == command_to_send) { /* handled elsewhere */
             if (const auto a {repeat_cmd_.find(command_to_send)}; a != repeat_cmd_.end())
                 [[unlikely]] {
-               static TimePoint next_response {};
+               static TimePoint next_response {}; /* MidiReceiver dispatch thread only */
                if (const auto now {Clock::now()}; next_response < now) {
                   next_response = now + kDelay;
                   if ((mm.message_type_byte == rsj::MessageType::kCc
@@ -209,7 +387,13 @@ void LrIpcOut::MidiCmdCallback(rsj::MidiMessage mm)
                const auto wrap {std::ranges::find(wrap_, command_to_send) != wrap_.end()};
 #endif
                const auto computed_value {controls_model_.ControllerToPlugin(mm, wrap)};
-               SendCommand(fmt::format(FMT_STRING("{} {}\n"), command_to_send, computed_value));
+               if (mm.message_type_byte == rsj::MessageType::kNoteOn
+                   || buttons_.contains(command_to_send)) {
+                  SendCommand(fmt::format(FMT_STRING("{} {}\n"), command_to_send, computed_value));
+               }
+               else { /* parameter on a CC or pitch bend is continuous */
+                  SendValue(command_to_send, computed_value);
+               }
             }
          }
       }
@@ -227,7 +411,9 @@ void LrIpcOutShared::SendOut(std::shared_ptr<LrIpcOutShared> lr_ipc_out_shared)
       if (*command_copy == kTerminate) [[unlikely]] { return; }
       if (command_copy->back() != '\n') [[unlikely]] { /* should be terminated with \n */
          command_copy->push_back('\n');
-      } // ReSharper disable once CppLambdaCaptureNeverUsed
+      }
+      rsj::Tap(rsj::TapKind::kToLightroom, *command_copy);
+      // ReSharper disable once CppLambdaCaptureNeverUsed
       asio::async_write(lr_ipc_out_shared->socket_, asio::buffer(*command_copy),
           [command_copy, lr_ipc_out_shared](const asio::error_code& error, std::size_t) mutable {
          if (!error) [[likely]] { SendOut(std::move(lr_ipc_out_shared)); }
@@ -247,11 +433,14 @@ void LrIpcOut::SetRecenter(rsj::MidiMessageId mm)
    /* by capturing mm by copy, don't have to worry about later calls changing it--those will just
     * cancel and reschedule new one */
    try {
-      recenter_timer_.expires_after(kRecenterTimer);
-      recenter_timer_.async_wait([this, mm](const asio::error_code& error) {
-         if (!error && !thread_should_exit_.load(std::memory_order_acquire)) {
-            midi_sender_.Send(mm, controls_model_.SetToCenter(mm));
-         }
+      /* called on the MidiReceiver dispatch thread, timer is only touched on its own strand */
+      asio::dispatch(recenter_timer_.get_executor(), [this, mm] {
+         recenter_timer_.expires_after(kRecenterTimer);
+         recenter_timer_.async_wait([this, mm](const asio::error_code& error) {
+            if (!error && !thread_should_exit_.load(std::memory_order_acquire)) {
+               midi_sender_.Send(mm, controls_model_.SetToCenter(mm));
+            }
+         });
       });
    }
    catch (const std::exception& e) {
@@ -16,17 +16,20 @@
  *
  */
 #include <atomic>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include <asio/asio.hpp>
 
 #include "MidiUtilities.h"
+#include "ProfiledMutex.h"
 class CommandSet;
 class ControlsModel;
 class LrIpcOutShared;
@@ -58,6 +61,13 @@ class LrIpcOut {
 
    void SendCommand(std::string&& command);
    void SendCommand(const std::string& command);
+
+   /* Lightroom range and step of a parameter, as reported by the plugin. Values that round to the
+    * Lightroom value last sent for that parameter are then dropped. */
+   void SetParameterRange(const std::string& command, double min, double max, double step);
+   /* Lightroom reports value for the parameter. Unless that is the echo of the step last sent,
+    * the parameter changed in Lightroom, so the next value is sent even if it rounds the same. */
+   void ForgetSentValue(const std::string& command, double value);
    void SendingRestart();
    void SendingStop();
 
@@ -69,6 +79,8 @@ class LrIpcOut {
    void Connect(std::shared_ptr<LrIpcOutShared> lr_ipc_out_shared);
    void ConnectionMade();
    void MidiCmdCallback(rsj::MidiMessage mm);
+   void SendSubscriptions();
+   void SendValue(const std::string& command, double value);
    void SetRecenter(rsj::MidiMessageId mm);
    asio::steady_timer recenter_timer_;
    bool connected_ {false};
@@ -77,9 +89,11 @@ class LrIpcOut {
    const Profile& profile_;
    const std::unordered_map<std::string, std::pair<std::string, std::string>>& repeat_cmd_;
    const std::vector<std::string>& wrap_;
+   const std::unordered_set<std::string>& buttons_;
    ControlsModel& controls_model_;
-   mutable std::mutex callback_mtx_;
+   mutable rsj::ProfiledMutex<"LrIpcOut callbacks"> callback_mtx_;
    std::atomic<bool> thread_should_exit_ {false};
+   std::atomic<uint64_t> subscribed_version_ {UINT64_MAX}; /* Profile version last sent */
    std::shared_ptr<LrIpcOutShared> lr_ipc_out_shared_;
    std::vector<std::function<void(bool, bool)>> callbacks_ {};
 };
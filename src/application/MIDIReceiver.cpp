@@ -22,7 +22,9 @@
 
 #include <fmt/format.h>
 
+#include "AllocationCounter.h"
 #include "Devices.h"
+#include "EventTap.h"
 #include "Misc.h"
 
 #ifdef _WIN32
@@ -32,19 +34,18 @@ extern "C" {
 }
 #endif
 
-namespace {
-   constexpr rsj::MidiMessage kTerminate {rsj::MessageType::kCc, 129, 0, 0}; /* impossible */
-} // namespace
+MidiReceiver::~MidiReceiver()
+{
+   /* in case Stop wasn't called, so the dispatch thread can be joined */
+   stop_dispatch_.store(true, std::memory_order_release);
+   Wake();
+}
 
 void MidiReceiver::Start()
 {
    try {
+      StartDispatch();
       InitDevices();
-      dispatch_messages_future_ = std::async(std::launch::async, [this] {
-         rsj::LabelThread(MIDI2LR_UC_LITERAL("MidiReceiver dispatch messages thread"));
-         MIDI2LR_FAST_FLOATS;
-         DispatchMessages();
-      });
    }
    catch (const std::exception& e) {
       MIDI2LR_E_RESPONSE;
@@ -52,26 +53,72 @@ void MidiReceiver::Start()
    }
 }
 
+#ifdef MIDI2LR_TESTS
+void MidiReceiver::StartHeadless()
+{
+   try {
+      {
+         auto lock {std::scoped_lock(lanes_mutex_)};
+         lanes_.push_back(std::make_unique<Lane>(*this, lanes_.size()));
+      }
+      StartDispatch();
+   }
+   catch (const std::exception& e) {
+      MIDI2LR_E_RESPONSE;
+      throw;
+   }
+}
+
+void MidiReceiver::Feed(const juce::MidiMessage& message) { lanes_.front()->Receive(message); }
+#endif
+
+void MidiReceiver::StartDispatch()
+{
+   dispatch_future_ = std::async(std::launch::async, [this] {
+      rsj::LabelThread(MIDI2LR_UC_LITERAL("MidiReceiver dispatch messages thread"));
+      MIDI2LR_FAST_FLOATS;
+      DispatchMessages();
+   });
+}
+
 void MidiReceiver::Stop()
 {
-   for (const auto& dev : input_devices_) {
-      dev->stop();
-      rsj::Log(fmt::format(FMT_STRING("Stopped input device {}."), dev->getName().toStdString()));
+   try {
+      StopLanes();
+      if (const auto remaining {direct_.clear_count()}) {
+         rsj::Log(fmt::format(FMT_STRING("{} left in MidiReceiver direct queue in Stop."),
+             remaining));
+      }
+      direct_.close();
+      stop_dispatch_.store(true, std::memory_order_release);
+      Wake(); /* ends DispatchMessages */
    }
-   if (const auto remaining {messages_.clear_count_push({kTerminate, nullptr})}) {
-      rsj::Log(fmt::format(FMT_STRING("{} left in queue in MidiReceiver StopRunning."), remaining));
+   catch (const std::exception& e) {
+      MIDI2LR_E_RESPONSE;
+      throw;
+   }
+}
+
+void MidiReceiver::StopLanes()
+{
+   try {
+      auto lock {std::scoped_lock(lanes_mutex_)};
+      for (const auto& lane : lanes_) { lane->Stop(); }
+   }
+   catch (const std::exception& e) {
+      MIDI2LR_E_RESPONSE;
+      throw;
    }
 }
 
 void MidiReceiver::RescanDevices()
 {
    try {
-      for (const auto& dev : input_devices_) {
-         dev->stop();
-         rsj::Log(fmt::format(FMT_STRING("Stopped input device {}."),
-             dev->getName().toStdString()));
+      StopLanes();
+      {
+         auto lock {std::scoped_lock(lanes_mutex_)};
+         lanes_.clear();
       }
-      input_devices_.clear();
       rsj::Log("Cleared input devices.");
    }
    catch (const std::exception& e) {
@@ -85,19 +132,10 @@ void MidiReceiver::TryToOpen()
 {
    try {
       const auto available_devices {juce::MidiInput::getAvailableDevices()};
+      auto lock {std::scoped_lock(lanes_mutex_)};
       for (const auto& device : available_devices) {
-         if (auto open_device {juce::MidiInput::openDevice(device.identifier, this)}) {
-            if (devices_.EnabledOrNew(open_device->getDeviceInfo(), "input")) {
-               open_device->start();
-               rsj::Log(fmt::format(FMT_STRING("Opened input device {}."),
-                   open_device->getName().toStdString()));
-               input_devices_.push_back(std::move(open_device));
-            }
-            else {
-               rsj::Log(fmt::format(FMT_STRING("Ignored input device {}."),
-                   open_device->getName().toStdString()));
-            }
-         }
+         auto lane {std::make_unique<Lane>(*this, lanes_.size())};
+         if (lane->Open(device)) { lanes_.push_back(std::move(lane)); }
       }
    }
    catch (const std::exception& e) {
@@ -112,13 +150,13 @@ void MidiReceiver::InitDevices()
    try {
       rsj::Log("Trying to open input devices.");
       TryToOpen();
-      if (input_devices_.empty()) /* encountering errors first try on MacOS */
+      if (lanes_.empty()) /* encountering errors first try on MacOS */
       {
          rsj::Log("Retrying to open input devices.");
          std::this_thread::sleep_for(20ms);
          rsj::Log("20ms sleep for open input devices.");
          TryToOpen();
-         if (input_devices_.empty()) /* encountering errors second try on MacOS */
+         if (lanes_.empty()) /* encountering errors second try on MacOS */
          {
             rsj::Log("Retrying second time to open input devices.");
             std::this_thread::sleep_for(80ms);
@@ -133,45 +171,146 @@ void MidiReceiver::InitDevices()
    }
 }
 
+MidiReceiver::Lane::~Lane()
+{
+   try {
+      Stop();
+   }
+   catch (const std::exception& e) {
+      MIDI2LR_E_RESPONSE;
+   }
+}
+
+bool MidiReceiver::Lane::Open(const juce::MidiDeviceInfo& info)
+{
+   try {
+      if (auto open_device {juce::MidiInput::openDevice(info.identifier, this)}) {
+         if (owner_.devices_.EnabledOrNew(open_device->getDeviceInfo(), "input")) {
+            device_ = std::move(open_device);
+            device_->start();
+            rsj::Log(fmt::format(FMT_STRING("Opened input device {} in lane {}."),
+                device_->getName().toStdString(), slot_));
+            return true;
+         }
+         rsj::Log(fmt::format(FMT_STRING("Ignored input device {}."),
+             open_device->getName().toStdString()));
+      }
+      return false;
+   }
+   catch (const std::exception& e) {
+      MIDI2LR_E_RESPONSE;
+      throw;
+   }
+}
+
+void MidiReceiver::Lane::Stop()
+{
+   try {
+      if (device_) {
+         device_->stop();
+         rsj::Log(fmt::format(FMT_STRING("Stopped input device {}."),
+             device_->getName().toStdString()));
+         device_.reset();
+      }
+      if (!messages_.closed()) {
+         if (const auto remaining {messages_.clear_count()}) {
+            rsj::Log(fmt::format(FMT_STRING("{} left in queue in MidiReceiver lane {} Stop."),
+                remaining, slot_));
+         }
+         messages_.close();
+         std::visit(
+             [this](const auto& pipeline) {
+                rsj::Log(fmt::format(FMT_STRING("MidiReceiver lane {} pipeline stage counts: {}."),
+                    slot_, pipeline.Counts()));
+             },
+             pipeline_);
+      }
+   }
+   catch (const std::exception& e) {
+      MIDI2LR_E_RESPONSE;
+      throw;
+   }
+}
+
+size_t MidiReceiver::Lane::Decode(std::vector<rsj::MidiMessage>& decoded,
+    rsj::AllocationMeter& meter)
+{
+   try {
+      events_.clear();
+      const auto taken {messages_.pop_some(events_, kBatch)};
+      std::visit(
+          [this, &decoded, &meter](auto& pipeline) {
+             const auto sink {[&decoded](rsj::MidiMessage mm) {
+                rsj::Tap(rsj::TapKind::kMidiIn, mm);
+                decoded.push_back(mm);
+             }};
+             for (const auto event : events_) {
+                meter.Begin();
+                pipeline(rsj::MidiMessage(event), sink);
+                if (meter.End()) {
+                   rsj::Log(fmt::format(
+                       FMT_STRING("MidiReceiver lane {} is over the allocation budget: {:.2f} "
+                                  "allocations per event, budget {}."),
+                       slot_, meter.PerEvent(), meter.Budget()));
+                }
+             }
+          },
+          pipeline_);
+      return taken;
+   }
+   catch (const std::exception& e) {
+      MIDI2LR_E_RESPONSE;
+      throw;
+   }
+}
+
+/* Each round takes up to kBatch messages from every lane and from the direct queue, decoding
+ * under lanes_mutex_, then passes them to the callbacks with the lock released. It sleeps on wake_
+ * once a round finds nothing; wake_ is read before the round, so a message queued during it isn't
+ * missed */
 void MidiReceiver::DispatchMessages()
 {
    try {
-      for (auto popped = messages_.pop(); popped.first != kTerminate; popped = messages_.pop()) {
+      rsj::AllocationMeter decode_meter {"MidiReceiver decode", rsj::kDispatchAllocationBudget};
+      rsj::AllocationMeter meter {"MidiReceiver dispatch", rsj::kDispatchAllocationBudget};
+      std::vector<rsj::MidiMessage> messages;
+      messages.reserve(kBatch * 2);
+      while (!stop_dispatch_.load(std::memory_order_acquire)) {
+         const auto seen {wake_.load(std::memory_order_acquire)};
+         messages.clear();
+         auto taken {direct_.pop_some(messages, kBatch)};
+         {
+            auto lock {std::scoped_lock(lanes_mutex_)};
+            for (const auto& lane : lanes_) { taken += lane->Decode(messages, decode_meter); }
+         }
+         if (taken == 0) {
+            wake_.wait(seen, std::memory_order_acquire);
+            continue;
+         }
 #ifdef _WIN32
          SetThreadExecutionState(0x00000002UL | 0x00000001UL);
 #endif
-         switch (popped.first.message_type_byte) {
-         case rsj::MessageType::kCc:
-            if (const auto result {filters_[popped.second](popped.first)}; result.is_nrpn) {
-               if (result.is_ready) {
-                  const rsj::MidiMessage nrpn_message {
-                      rsj::MessageType::kCc, popped.first.channel, result.control, result.value};
-                  for (const auto& cb : callbacks_) {
-#pragma warning(suppress : 26489) /* checked for existence before adding to callbacks_ */
-                     cb(nrpn_message);
-                  }
-               }
-               break;
-            }
-            [[fallthrough]]; /* if not nrpn, handle like other messages */
-         case rsj::MessageType::kNoteOn:
-         case rsj::MessageType::kPw:
+         for (const auto mm : messages) {
+            meter.Begin();
             for (const auto& cb : callbacks_) {
 #pragma warning(suppress : 26489) /* checked for existence before adding to callbacks_ */
-               cb(popped.first);
+               cb(mm);
+            }
+            if (meter.End()) {
+               rsj::Log(fmt::format(FMT_STRING("MidiReceiver dispatch is over the allocation "
+                                               "budget: {:.2f} allocations per event, budget {}."),
+                   meter.PerEvent(), meter.Budget()));
             }
-            break;
-         case rsj::MessageType::kChanPressure:
-         case rsj::MessageType::kKeyPressure:
-         case rsj::MessageType::kNoteOff:
-         case rsj::MessageType::kPgmChange:
-         case rsj::MessageType::kSystem:
-            break; /* no action if other type of MIDI message */
          }
       }
+      if constexpr (rsj::kCountAllocations) {
+         rsj::Log(fmt::format(FMT_STRING("MidiReceiver dispatch allocations: {} in {} steady-state "
+                                         "events, {:.2f} per event."),
+             meter.Allocations(), meter.Events(), meter.PerEvent()));
+      }
    }
    catch (const std::exception& e) {
       MIDI2LR_E_RESPONSE;
       throw;
    }
-}
\ No newline at end of file
+}
@@ -15,16 +15,23 @@
  * see <http://www.gnu.org/licenses/>.
  *
  */
+#include <atomic>
+#include <cstdint>
+#include <deque>
 #include <functional>
 #include <future>
-#include <map> /* map faster than unordered_map for very few members */
 #include <memory>
+#include <mutex>
+#include <variant>
 #include <vector>
 
 #include <juce_audio_devices/juce_audio_devices.h>
 
+#include "AllocationCounter.h"
 #include "Concurrency.h"
+#include "MidiPipeline.h"
 #include "MidiUtilities.h"
+#include "ProfiledMutex.h"
 
 class Devices;
 
@@ -32,11 +39,11 @@ class Devices;
 #define _In_ //-V3547
 #endif
 
-class MidiReceiver final : juce::MidiInputCallback {
+class MidiReceiver final {
  public:
    explicit MidiReceiver(Devices& devices) : devices_(devices) {}
 
-   ~MidiReceiver() = default; // NOLINT(modernize-use-override)
+   ~MidiReceiver();
    MidiReceiver(const MidiReceiver& other) = delete;
    MidiReceiver(MidiReceiver&& other) = delete;
    MidiReceiver& operator=(const MidiReceiver& other) = delete;
@@ -45,30 +52,112 @@ class MidiReceiver final : juce::MidiInputCallback {
    void Start();
    void Stop();
 
+#ifdef MIDI2LR_TESTS
+   /* for the unit tests: starts like Start, but with one lane that has no device. Feed passes it
+    * messages as a device would */
+   void StartHeadless();
+   void Feed(const juce::MidiMessage& message);
+#endif
+
+   /* call before Start; lanes opened afterwards (Start, RescanDevices) use the setting */
+   void SetCc14BitDecoding(bool enabled) noexcept { cc14bit_decoding_ = enabled; }
+
    template<class T>
    void AddCallback(_In_ T* const object, _In_ void (T::*const mf)(rsj::MidiMessage))
    {
       if (object && mf) { callbacks_.emplace_back(std::bind_front(mf, object)); }
    }
 
- private:
-   void DispatchMessages();
-
-   void handleIncomingMidiMessage(juce::MidiInput* device,
-       const juce::MidiMessage& message) override
+   /* for input sources other than MIDI devices, such as OscReceiver, whose messages are already
+    * complete and so skip the pipeline. Queues the message for the dispatch thread, which takes
+    * these in turn with the lanes, so callbacks are never called concurrently */
+   void Dispatch(rsj::MidiMessage mm)
    {
-      messages_.push({rsj::MidiMessage(message), device});
+      if (direct_.push(mm)) { Wake(); }
    }
 
+ private:
+   /* At most this many messages are taken from a lane, or from the direct queue, before the
+    * dispatch thread moves on to the next */
+   static constexpr size_t kBatch {64};
+
+   /* One lane per open input device. Each lane is its device's juce callback, so incoming messages
+    * go straight to the device's own queue without a lookup, and each lane has its own pipeline
+    * state. A single dispatch thread decodes and passes messages to the callbacks, as the callback
+    * targets (ControlsModel, LrIpcOut, ProfileManager, Profile) were written for one caller at a
+    * time. It takes up to kBatch messages from each lane in turn, so a burst from one device
+    * delays the others by at most one batch. */
+   class Lane final : juce::MidiInputCallback {
+    public:
+      Lane(MidiReceiver& owner, size_t slot) : owner_ {owner}, slot_ {slot}
+      {
+         messages_.set_capacity(kCapacity, rsj::Overflow::kDropOldest);
+         events_.reserve(kBatch);
+         if (owner.cc14bit_decoding_) { pipeline_.emplace<rsj::Cc14BitPipeline>(); }
+      }
+
+      ~Lane(); // NOLINT(modernize-use-override)
+      Lane(const Lane& other) = delete;
+      Lane(Lane&& other) = delete;
+      Lane& operator=(const Lane& other) = delete;
+      Lane& operator=(Lane&& other) = delete;
+      bool Open(const juce::MidiDeviceInfo& info);
+      /* dispatch thread only: decodes up to kBatch queued events onto the back of decoded.
+       * Returns the number of events taken */
+      size_t Decode(std::vector<rsj::MidiMessage>& decoded, rsj::AllocationMeter& meter);
+      void Stop();
+
+      void Receive(const juce::MidiMessage& message)
+      {
+         if (messages_.push(rsj::MidiEvent(message))) { owner_.Wake(); }
+      }
+
+    private:
+      /* A stalled dispatch thread must not block the device's callback or grow without limit, so
+       * the oldest raw events are dropped instead */
+      static constexpr size_t kCapacity {4096};
+
+      void handleIncomingMidiMessage(juce::MidiInput* /*device*/,
+          const juce::MidiMessage& message) override
+      {
+         Receive(message);
+      }
+
+      MidiReceiver& owner_;
+      rsj::ConcurrentQueue<rsj::MidiEvent, std::deque<rsj::MidiEvent>,
+          rsj::ProfiledMutex<"MidiReceiver lane">>
+          messages_;
+      size_t slot_;
+      std::vector<rsj::MidiEvent> events_;                                /* dispatch thread */
+      std::variant<rsj::StandardPipeline, rsj::Cc14BitPipeline> pipeline_; /* dispatch thread */
+      std::unique_ptr<juce::MidiInput> device_;
+   };
+
+   void DispatchMessages();
    void InitDevices();
+   void StartDispatch();
+   void StopLanes();
    void TryToOpen(); /* inner code for InitDevices */
 
+   void Wake() noexcept
+   {
+      wake_.fetch_add(1, std::memory_order_release);
+      wake_.notify_one();
+   }
+
+   bool cc14bit_decoding_ {false};
    Devices& devices_;
-   rsj::ConcurrentQueue<std::pair<rsj::MidiMessage, juce::MidiInput*>> messages_;
-   std::map<juce::MidiInput*, NrpnFilter> filters_ {};
    std::vector<std::function<void(rsj::MidiMessage)>> callbacks_;
-   std::vector<std::unique_ptr<juce::MidiInput>> input_devices_;
-   std::future<void> dispatch_messages_future_; /* destroy this before callbacks_ */
+   rsj::ConcurrentQueue<rsj::MidiMessage, std::deque<rsj::MidiMessage>,
+       rsj::ProfiledMutex<"MidiReceiver direct">>
+       direct_;
+   std::atomic<uint32_t> wake_ {0}; /* bumped for each message queued, waited on when idle */
+   std::atomic<bool> stop_dispatch_ {false};
+   /* held while the dispatch thread decodes from the lanes and while lanes_ changes, never while
+    * callbacks run */
+   rsj::ProfiledMutex<"MidiReceiver lanes"> lanes_mutex_;
+   std::vector<std::unique_ptr<Lane>> lanes_; /* destroy these before callbacks_ */
+   std::future<void> dispatch_future_;        /* destroy this before other members */
 };
 
 #endif
@@ -16,6 +16,7 @@
 #include "MIDISender.h"
 
 #include <exception>
+#include <mutex>
 #include <utility>
 
 #include <fmt/format.h>
@@ -43,6 +44,7 @@ void MidiSender::Start()
 void MidiSender::Send(rsj::MidiMessageId id, int value) const
 {
    try {
+      auto lock {std::scoped_lock {mutex_}};
       if (id.msg_id_type == rsj::MessageType::kPw) {
          const auto msg {juce::MidiMessage::pitchWheel(id.channel, value)};
          for (const auto& dev : output_devices_) { dev->sendMessageNow(msg); }
@@ -58,24 +60,30 @@ void MidiSender::Send(rsj::MidiMessageId id, int value) const
             const auto msg {
                 juce::MidiMessage::controllerEvent(id.channel, id.control_number, value)};
             for (const auto& dev : output_devices_) { dev->sendMessageNow(msg); }
+            if (id.control_number == 6 || id.control_number == 38
+                || (id.control_number >= 98 && id.control_number <= 101)) {
+               /* data entry or NRPN/RPN select sent directly, device's selection no longer known */
+               SelectedNrpn(id.GetChannel()) = kNoNrpn;
+            }
          }
-         else {
-            /* NRPN */
-            const auto msg_parm_msb {
-                juce::MidiMessage::controllerEvent(id.channel, 99, id.control_number >> 7 & 0x7F)};
-            const auto msg_parm_lsb {
-                juce::MidiMessage::controllerEvent(id.channel, 98, id.control_number & 0x7f)};
-            const auto msg_val_msb {
-                juce::MidiMessage::controllerEvent(id.channel, 6, value >> 7 & 0x7F)};
-            const auto msg_val_lsb {
-                juce::MidiMessage::controllerEvent(id.channel, 38, value & 0x7f)};
+         else if (rsj::IsCc14Bit(id.control_number)) {
+            /* 14-bit CC pair, MSB first */
+            const auto controller {id.control_number - rsj::kCc14BitBase};
+            const auto msg_msb {
+                juce::MidiMessage::controllerEvent(id.channel, controller, value >> 7 & 0x7F)};
+            const auto msg_lsb {juce::MidiMessage::controllerEvent(id.channel,
+                controller + rsj::kCc14BitPairs, value & 0x7F)};
             for (const auto& dev : output_devices_) {
-               dev->sendMessageNow(msg_parm_msb);
-               dev->sendMessageNow(msg_parm_lsb);
-               dev->sendMessageNow(msg_val_msb);
-               dev->sendMessageNow(msg_val_lsb);
+               dev->sendMessageNow(msg_msb);
+               dev->sendMessageNow(msg_lsb);
+            }
+            if (controller == 6) { /* data entry pair, CC 6/38 */
+               SelectedNrpn(id.GetChannel()) = kNoNrpn;
             }
          }
+         else {
+            SendNrpn(id, value);
+         }
       }
       else {
          constexpr auto msge {"MIDISender: Unexpected data type: {:n}."};
@@ -91,9 +99,40 @@ void MidiSender::Send(rsj::MidiMessageId id, int value) const
    }
 }
 
+void MidiSender::SendNrpn(const rsj::MidiMessageId id, const int value) const
+{
+   /* called under lock. Data entry (CC 6/38) applies to the last selected parameter, so the
+    * parameter number is only sent when it differs from what the devices already have */
+   const auto channel {id.channel};
+   const auto parameter {id.control_number};
+   const auto msg_val_msb {juce::MidiMessage::controllerEvent(channel, 6, value >> 7 & 0x7F)};
+   const auto msg_val_lsb {juce::MidiMessage::controllerEvent(channel, 38, value & 0x7f)};
+   auto& selected {SelectedNrpn(id.GetChannel())};
+   if (selected != parameter) {
+      const auto msg_parm_msb {
+          juce::MidiMessage::controllerEvent(channel, 99, parameter >> 7 & 0x7F)};
+      const auto msg_parm_lsb {juce::MidiMessage::controllerEvent(channel, 98, parameter & 0x7f)};
+      for (const auto& dev : output_devices_) {
+         dev->sendMessageNow(msg_parm_msb);
+         dev->sendMessageNow(msg_parm_lsb);
+         dev->sendMessageNow(msg_val_msb);
+         dev->sendMessageNow(msg_val_lsb);
+      }
+      selected = parameter;
+      return;
+   }
+   for (const auto& dev : output_devices_) {
+      dev->sendMessageNow(msg_val_msb);
+      dev->sendMessageNow(msg_val_lsb);
+   }
+}
+
 void MidiSender::RescanDevices()
 {
    try {
+      auto lock {std::scoped_lock {mutex_}};
+      /* new devices haven't seen any NRPN select */
+      selected_nrpn_.fill(kNoNrpn);
       output_devices_.clear();
       rsj::Log("Cleared output devices.");
       InitDevices();
@@ -15,25 +15,29 @@
  * see <http://www.gnu.org/licenses/>.
  *
  */
+#include <array>
 #include <memory>
+#include <mutex>
 #include <vector>
 
+#include "MidiUtilities.h"
+#include "ProfiledMutex.h"
+
 class Devices;
 
 namespace juce {
    class MidiOutput;
 } // namespace juce
 
-namespace rsj {
-   struct MidiMessageId;
-} // namespace rsj
-
 //-V813_MINSIZE=13 /* warn if passing structure by value > 12 bytes (3*sizeof(int)) */
 
 /* juce MIDI send functions have 1-based channel, so does rsj::MidiMessageId */
 class MidiSender {
  public:
-   explicit MidiSender(Devices& devices) noexcept : devices_(devices) {}
+   explicit MidiSender(Devices& devices) noexcept : devices_(devices)
+   {
+      selected_nrpn_.fill(kNoNrpn);
+   }
 
    ~MidiSender() { output_devices_.clear(); /* close devices */ }
 
@@ -47,8 +51,22 @@ class MidiSender {
 
  private:
    void InitDevices();
+   void SendNrpn(rsj::MidiMessageId id, int value) const;
+
+   [[nodiscard]] int& SelectedNrpn(rsj::Channel channel) const noexcept
+   {
+      return selected_nrpn_[channel.Index()];
+   }
+
    Devices& devices_;
 
+   /* Running NRPN: every device gets the same messages, so the parameter last selected with CC
+    * 99/98 is the same on each. Tracked per channel, -1 when unknown. Cleared on rescan and when a
+    * plain CC or 14-bit pair touches the parameter-number or data-entry controllers. */
+   static constexpr int kNoNrpn {-1};
+   mutable std::array<int, rsj::Channel::kCount> selected_nrpn_ {};
+   mutable rsj::ProfiledMutex<"MidiSender"> mutex_; /* guards output_devices_ and selected_nrpn_ */
+
    std::vector<std::unique_ptr<juce::MidiOutput>> output_devices_;
 };
 
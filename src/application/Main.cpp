@@ -34,16 +34,20 @@
 #include "CommandSet.h"
 #include "ControlsModel.h"
 #include "Devices.h"
+#include "EventTap.h"
 #include "LR_IPC_In.h"
 #include "LR_IPC_Out.h"
 #include "MIDIReceiver.h"
 #include "MIDISender.h"
 #include "MainWindow.h"
 #include "Misc.h"
+#include "OscReceiver.h"
 #include "PWoptions.h"
 #include "Profile.h"
 #include "ProfileManager.h"
+#include "ProfiledMutex.h"
 #include "SettingsManager.h"
+#include "UnitTests.h"
 #include "VersionChecker.h"
 #ifdef _WIN32
 #include <array>
@@ -174,7 +178,15 @@ class MIDI2LRApplication final : public juce::JUCEApplication {
       return ProjectInfo::versionString;
    }
 
-   bool moreThanOneInstanceAllowed() noexcept override { return false; }
+   bool moreThanOneInstanceAllowed() noexcept override
+   {
+#ifdef MIDI2LR_TESTS
+      /* a test run mustn't hand its command line to a running MIDI2LR and exit */
+      return getCommandLineParameters() == rsj::kRunTestsString;
+#else
+      return false;
+#endif
+   }
 
    void initialise(const juce::String& command_line) override
    {
@@ -186,6 +198,14 @@ class MIDI2LRApplication final : public juce::JUCEApplication {
           * needs to delete. If during the initialise() method, the application decides not to
           * start-up after all, it can just call the quit() method and the event loop won't be
           * run. */
+#ifdef MIDI2LR_TESTS
+         if (command_line == rsj::kRunTestsString) {
+            tests_only_ = true;
+            setApplicationReturnValue(rsj::RunUnitTests() == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+            quit();
+            return;
+         }
+#endif
          if (command_line != kShutDownString) {
             MIDI2LR_FAST_FLOATS;
             rsj::LabelThread(MIDI2LR_UC_LITERAL("Main MIDI2LR thread"));
@@ -217,10 +237,13 @@ class MIDI2LRApplication final : public juce::JUCEApplication {
             main_window_ = std::make_unique<MainWindow>(getApplicationName(), command_set_,
                 profile_, profile_manager_, settings_manager_, lr_ipc_out_, midi_receiver_,
                 midi_sender_);
+            midi_receiver_.SetCc14BitDecoding(settings_manager_.GetCc14BitEnabled());
             midi_receiver_.Start();
             midi_sender_.Start();
             lr_ipc_out_.Start();
             lr_ipc_in_.Start();
+            osc_receiver_.Start(settings_manager_.GetOscPort(), settings_manager_.GetOscRemote());
+            event_tap_server_.Start(settings_manager_.GetEventTapPort());
             /* Check for latest version */
             version_checker_.Start();
          }
@@ -243,9 +266,14 @@ class MIDI2LRApplication final : public juce::JUCEApplication {
        * loop is no longer running at this point. */
 
       /*Primary goals: 1) remove callbacks in LR_IPC_Out and MIDIReceiver before the callee is
-       * destroyed, 2) stop additional threads in VersionChecker, LR_IPC_In, LR_IPC_Out and
-       * MIDIReceiver. Add to this list if new threads or callback lists are developed in this
-       * app. */
+       * destroyed, 2) stop additional threads in VersionChecker, LR_IPC_In, LR_IPC_Out,
+       * OscReceiver, EventTapServer and MIDIReceiver. Add to this list if new threads or callback
+       * lists are developed in this app. */
+#ifdef MIDI2LR_TESTS
+      if (tests_only_) { return; } /* nothing was loaded, so nothing is saved */
+#endif
+      event_tap_server_.Stop();
+      osc_receiver_.Stop();
       midi_receiver_.Stop();
       lr_ipc_in_.Stop();
       lr_ipc_out_.Stop();
@@ -253,6 +281,7 @@ class MIDI2LRApplication final : public juce::JUCEApplication {
       io_context_.stop();
       DefaultProfileSave();
       SaveControlsModel();
+      rsj::LogLockContention();
    }
 
    void systemRequestedQuit() override
@@ -374,50 +403,63 @@ class MIDI2LRApplication final : public juce::JUCEApplication {
       }
    }
 
-   void SetAppFont() const noexcept
+   /* Maps the font file rather than reading it into a MemoryBlock. The platform typeface copies
+    * what it needs, so the mapping is released on return. */
+   [[nodiscard]] static juce::Typeface::Ptr LoadTypeface(const juce::String& file_name)
+   {
+      const auto font_file {juce::File::getSpecialLocation(juce::File::currentApplicationFile)
+                                .getSiblingFile(file_name)};
+      const juce::MemoryMappedFile mapped {font_file, juce::MemoryMappedFile::readOnly};
+      if (mapped.getData() == nullptr) {
+         rsj::Log(fmt::format(FMT_STRING("Unable to load font file {}."), file_name.toStdString()));
+         return nullptr;
+      }
+      return juce::Typeface::createSystemTypefaceFor(mapped.getData(), mapped.getSize());
+   }
+
+   void UseTypeface(const juce::Typeface::Ptr& typeface)
+   {
+      if (typeface == nullptr) { return; }
+      juce::LookAndFeel::getDefaultLookAndFeel().setDefaultSansSerifTypeface(typeface);
+      juce::Typeface::clearTypefaceCache();
+      if (main_window_) { main_window_->RepaintAll(); }
+   }
+
+   void SetAppFont() noexcept
    {
       try {
          using namespace std::string_literals;
          const auto& lang {command_set_.GetLanguage()};
-         juce::String font1_name;
-         juce::String font2_name;
-         if (lang == "ko"s) { font1_name = "NotoSansKR-Regular.otf"; }
+         juce::String cjk_font_name;
+         if (lang == "ko"s) { cjk_font_name = "NotoSansKR-Regular.otf"; }
          else if (rollbear::any_of("zh_TW"s, "zh_tw"s) == lang) {
-            font1_name = "NotoSansTC-Regular.otf";
+            cjk_font_name = "NotoSansTC-Regular.otf";
          }
          else if (rollbear::any_of("zh_CN"s, "zh_cn"s) == lang) {
-            font1_name = "NotoSansSC-Regular.otf";
+            cjk_font_name = "NotoSansSC-Regular.otf";
          }
          else if (lang == "ja"s) {
-            font1_name = "NotoSansJP-Regular.otf";
-         }
-         else {
-            font1_name = "NotoSans-Regular-MIDI2LR.ttf";
-            font2_name = "NotoSans-Bold-MIDI2LR.ttf";
-         }
-         juce::MemoryBlock font_data {};
-         auto font_file = juce::File::getSpecialLocation(juce::File::currentApplicationFile)
-                              .getSiblingFile(font1_name);
-         if (font_file.loadFileAsData(font_data)) {
-            juce::LookAndFeel::getDefaultLookAndFeel().setDefaultSansSerifTypeface(
-                juce::Typeface::createSystemTypefaceFor(font_data.getData(), font_data.getSize()));
+            cjk_font_name = "NotoSansJP-Regular.otf";
          }
-         else {
-            rsj::Log(fmt::format(FMT_STRING("Unable to load primary font file {}."),
-                font1_name.toStdString()));
+         if (cjk_font_name.isEmpty()) {
+            /* small fonts, load now */
+            UseTypeface(LoadTypeface("NotoSans-Regular-MIDI2LR.ttf"));
+            [[maybe_unused]] const auto bold {LoadTypeface("NotoSans-Bold-MIDI2LR.ttf")};
+            return;
          }
-         if (font2_name.isNotEmpty()) {
-            font_data.reset();
-            font_file = juce::File::getSpecialLocation(juce::File::currentApplicationFile)
-                            .getSiblingFile(font2_name);
-            if (font_file.loadFileAsData(font_data)) {
-               juce::Typeface::createSystemTypefaceFor(font_data.getData(), font_data.getSize());
+         /* CJK fonts are several MB, load them off the startup path and switch over when ready */
+         font_loader_ = std::async(std::launch::async, [this, cjk_font_name] {
+            rsj::LabelThread(MIDI2LR_UC_LITERAL("font loader"));
+            try {
+               if (auto typeface {LoadTypeface(cjk_font_name)}) {
+                  juce::MessageManager::callAsync(
+                      [this, typeface = std::move(typeface)] { UseTypeface(typeface); });
+               }
             }
-            else {
-               rsj::Log(fmt::format(FMT_STRING("Unable to load bold font file {}."),
-                   font2_name.toStdString()));
+            catch (const std::exception& e) {
+               MIDI2LR_E_RESPONSE;
             }
-         }
+         });
       }
       catch (const std::exception& e) {
          MIDI2LR_E_RESPONSE;
@@ -429,9 +471,13 @@ class MIDI2LRApplication final : public juce::JUCEApplication {
     * pointer created by createDefaultAppLogger */
    /* forcing assignment to static early in construction */
    [[maybe_unused]] const SetLogger dummy_ {};
+#ifdef MIDI2LR_TESTS
+   bool tests_only_ {false}; /* ran the unit tests instead of starting */
+#endif
    asio::io_context io_context_ {};
    std::future<void> io_thread0_;
    std::future<void> io_thread1_;
+   std::future<void> font_loader_;
    [[maybe_unused]] asio::executor_work_guard<asio::io_context::executor_type> guard_ {
        asio::make_work_guard(io_context_)};
    Devices devices_ {};
@@ -440,11 +486,14 @@ class MIDI2LRApplication final : public juce::JUCEApplication {
    Profile profile_ {command_set_};
    MidiSender midi_sender_ {devices_};
    MidiReceiver midi_receiver_ {devices_};
+   OscReceiver osc_receiver_ {midi_receiver_, io_context_};
    LrIpcOut lr_ipc_out_ {
        command_set_, controls_model_, profile_, midi_sender_, midi_receiver_, io_context_};
    ProfileManager profile_manager_ {controls_model_, profile_, lr_ipc_out_, midi_receiver_};
-   LrIpcIn lr_ipc_in_ {controls_model_, profile_manager_, profile_, midi_sender_, io_context_};
+   LrIpcIn lr_ipc_in_ {
+       controls_model_, profile_manager_, profile_, midi_sender_, lr_ipc_out_, io_context_};
    SettingsManager settings_manager_ {profile_manager_, lr_ipc_out_};
+   EventTapServer event_tap_server_ {io_context_};
    [[maybe_unused]] const LookAndFeelMIDI2LR dummy1_;
    std::unique_ptr<MainWindow> main_window_ {nullptr};
    VersionChecker version_checker_ {settings_manager_};
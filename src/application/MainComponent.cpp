@@ -18,6 +18,7 @@
 #include <exception>
 #include <functional>
 #include <string>
+#include <utility>
 
 #include <fmt/format.h>
 #include <gsl/gsl>
@@ -167,7 +168,7 @@ void MainContentComponent::Init()
          auto component {std::make_unique<SettingsComponent>(settings_manager_)};
          component->Init();
          dialog_options.content.setOwned(component.release());
-         dialog_options.content->setSize(400, 300);
+         dialog_options.content->setSize(400, 465);
          settings_dialog_.reset(dialog_options.create());
          settings_dialog_->setVisible(true);
       };
@@ -267,7 +268,7 @@ void MainContentComponent::Init()
    }
 }
 
-void MainContentComponent::SaveProfile() const
+void MainContentComponent::SaveProfile()
 {
    juce::File profile_directory {settings_manager_.GetProfileDirectory()};
    if (!profile_directory.exists()) {
@@ -276,7 +277,14 @@ void MainContentComponent::SaveProfile() const
    juce::FileChooser chooser {juce::translate("Save profile"), profile_directory, "*.xml", true};
    if (chooser.browseForFileToSave(true)) {
       const auto selected_file {chooser.getResult().withFileExtension("xml")};
-      profile_.ToXmlFile(selected_file);
+      profile_.ToXmlFileAsync(selected_file,
+          [self = juce::Component::SafePointer {this}, name = selected_file.getFileName()](
+              const bool saved) {
+             if (saved && self) {
+                self->command_label_.setText(juce::translate("Profile saved") + ": " + name,
+                    juce::NotificationType::dontSendNotification);
+             }
+          });
    }
 }
 
@@ -297,10 +305,14 @@ void MainContentComponent::MidiCmdCallback(rsj::MidiMessage mm)
       /* Display the MIDI parameters and add/highlight row in table corresponding to the message msg
        * is 1-based for channel, which display expects */
       const rsj::MidiMessageId msg {mm};
-      last_command_ = fmt::format(FMT_STRING("{}: {}{} [{}]"), msg.channel, mm.message_type_byte,
-          msg.control_number, mm.value);
+      auto command {fmt::format(FMT_STRING("{}: {}{} [{}]"), msg.channel, mm.message_type_byte,
+          msg.control_number, mm.value)};
       profile_.InsertUnassigned(msg);
-      row_to_select_ = gsl::narrow_cast<size_t>(profile_.GetRowForMessage(msg));
+      {
+         auto lock {std::scoped_lock(last_command_mtx_)};
+         last_command_ = std::move(command);
+         row_to_select_ = gsl::narrow_cast<size_t>(profile_.GetRowForMessage(msg));
+      }
       triggerAsyncUpdate();
    }
    catch (const std::exception& e) {
@@ -376,13 +388,20 @@ void MainContentComponent::StandardLabelSettings(juce::Label& label_to_set)
 void MainContentComponent::handleAsyncUpdate()
 {
    try {
+      juce::String last_command;
+      size_t row_to_select {};
+      {
+         auto lock {std::scoped_lock(last_command_mtx_)};
+         last_command = last_command_;
+         row_to_select = row_to_select_;
+      }
       /* Update the last command label and set its color to green */
-      command_label_.setText(last_command_, juce::NotificationType::dontSendNotification);
+      command_label_.setText(last_command, juce::NotificationType::dontSendNotification);
       command_label_.setColour(juce::Label::backgroundColourId, juce::Colours::greenyellow);
       startTimer(1000);
       /* Update the command table to add and/or select row corresponding to midi command */
       command_table_.updateContent();
-      command_table_.selectRow(gsl::narrow_cast<int>(row_to_select_));
+      command_table_.selectRow(gsl::narrow_cast<int>(row_to_select));
    }
    catch (const std::exception& e) {
       MIDI2LR_E_RESPONSE;
@@ -16,6 +16,7 @@
  *
  */
 #include <memory>
+#include <mutex>
 
 #include <juce_core/juce_core.h>
 #include <juce_events/juce_events.h>
@@ -24,6 +25,7 @@
 
 #include "CommandTable.h"
 #include "CommandTableModel.h"
+#include "ProfiledMutex.h"
 #include "falco/ResizableLayout.h"
 class CommandSet;
 class LrIpcOut;
@@ -34,7 +36,7 @@ class ProfileManager;
 class SettingsManager;
 
 namespace rsj {
-   struct MidiMessage;
+   class MidiMessage;
 } // namespace rsj
 
 class MainContentComponent final :
@@ -52,7 +54,7 @@ class MainContentComponent final :
    MainContentComponent& operator=(const MainContentComponent& other) = delete;
    MainContentComponent& operator=(MainContentComponent&& other) = delete;
    void Init();
-   void SaveProfile() const;
+   void SaveProfile();
 
  private:
    void handleAsyncUpdate() override;
@@ -73,6 +75,8 @@ class MainContentComponent final :
    juce::Label version_label_ {
        "Version", juce::translate("Version ") + juce::String {ProjectInfo::versionString}};
    juce::String last_command_;
+   /* guards last_command_, row_to_select_ */
+   rsj::ProfiledMutex<"MainComponent last command"> last_command_mtx_;
    juce::TextButton disconnect_button_ {juce::translate("Halt sending to Lightroom")};
    juce::TextButton load_button_ {juce::translate("Load")};
    juce::TextButton remove_row_button_ {juce::translate("Clear ALL rows")};
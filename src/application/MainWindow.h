@@ -43,6 +43,8 @@ class MainWindow final : juce::DocumentWindow, juce::Timer {
    MainWindow& operator=(MainWindow&& other) = delete;
 
    void SaveProfile() const { window_content_->SaveProfile(); }
+   /* redraw window and contents, e.g., after the default typeface changes */
+   void RepaintAll() { repaint(); }
 
    /* Note: Be careful if you override any DocumentWindow methods - the base class uses a lot of
     * them, so by overriding you might break its functionality. It's best to do all your work in
@@ -0,0 +1,210 @@
+#ifndef MIDI2LR_MIDIPIPELINE_H_INCLUDED
+#define MIDI2LR_MIDIPIPELINE_H_INCLUDED
+/*
+ * This file is part of MIDI2LR. Copyright (C) 2015 by Rory Jaffe.
+ *
+ * MIDI2LR is free software: you can redistribute it and/or modify it under the terms of the GNU
+ * General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * MIDI2LR is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with MIDI2LR.  If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <utility>
+
+#include <fmt/format.h>
+#include <gsl/gsl>
+
+#include "MidiUtilities.h"
+
+/*****************************************************************************/
+/*************Pipeline stages*************************************************/
+/*****************************************************************************/
+/* A stage is a class with a kName, a StageCounter and a templated call operator taking the message
+ * and the next step of the pipeline. A stage calls next zero or more times before returning; it
+ * doesn't hold messages back. Stages are combined at compile time by MidiPipeline, so each
+ * configuration is a single inlined function. */
+namespace rsj {
+   /* Only touched by the thread running the pipeline. */
+   struct StageCounter {
+      uint64_t in {0};
+      uint64_t out {0};
+   };
+
+   /* Passes the message types that are dispatched to callbacks, drops the rest. */
+   class TypeStage {
+    public:
+      static constexpr auto kName {"type"};
+
+      template<class Next> void operator()(MidiMessage mm, Next&& next)
+      {
+         ++counter.in;
+         switch (mm.message_type_byte) {
+         case MessageType::kCc:
+         case MessageType::kNoteOn:
+         case MessageType::kPw:
+            ++counter.out;
+            std::forward<Next>(next)(mm);
+            break;
+         case MessageType::kChanPressure:
+         case MessageType::kKeyPressure:
+         case MessageType::kNoteOff:
+         case MessageType::kPgmChange:
+         case MessageType::kSystem:
+            break; /* no action if other type of MIDI message */
+         }
+      }
+
+      StageCounter counter {};
+   };
+
+   /* Assembles NRPN sequences, passing one message per completed NRPN. Other messages pass through
+    * unchanged. */
+   class NrpnStage {
+    public:
+      static constexpr auto kName {"nrpn"};
+
+      template<class Next> void operator()(MidiMessage mm, Next&& next)
+      {
+         ++counter.in;
+         if (mm.message_type_byte == MessageType::kCc) {
+            if (const auto result {filter_(mm)}; result.is_nrpn) {
+               if (result.is_ready) {
+                  ++counter.out;
+                  std::forward<Next>(next)(MidiMessage {
+                      MessageType::kCc, mm.GetChannel().Get(), result.control, result.value});
+               }
+               return;
+            }
+         }
+         ++counter.out;
+         std::forward<Next>(next)(mm);
+      }
+
+      StageCounter counter {};
+
+    private:
+      NrpnFilter filter_ {};
+   };
+
+   /* Combines 14-bit CC pairs: MSB on CC 0-31 and LSB on CC 32-63 of the same channel. Every MSB
+    * controller is passed as control kCc14BitBase + its number, so learning a control records the
+    * 14-bit id whether or not the device has sent an LSB yet. Nothing is held back, and a pair
+    * passes as one message:
+    * - a controller that sends its LSB after its MSB passes on the LSB, with the full value. The
+    *   MSB only updates the state;
+    * - a controller that sends MSBs alone passes on each MSB with the last LSB seen, or, before any
+    *   LSB, with the MSB repeated in the low bits so 127 reaches the top of the range;
+    * - an LSB sent alone passes with the last MSB.
+    * Which kind a controller is is learned as it sends: an LSB right after an MSB marks it as
+    * paired, and two MSBs in a row mark it as MSB alone, passing the second MSB. An LSB from a
+    * controller whose MSB hasn't been seen passes unchanged. */
+   class Cc14BitStage {
+    public:
+      static constexpr auto kName {"cc14"};
+
+      template<class Next> void operator()(MidiMessage mm, Next&& next)
+      {
+         ++counter.in;
+         const auto number {mm.GetControl().Get()};
+         if (mm.message_type_byte == MessageType::kCc && number < 2 * kCc14BitPairs) {
+            const auto is_msb {number < kCc14BitPairs};
+            const auto pair {is_msb ? number : number - kCc14BitPairs};
+#pragma warning(suppress : 26446 26482) /* rsj::Channel in range, pair bounds checked above */
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+            auto& state {state_[mm.GetChannel().Index()][gsl::narrow_cast<size_t>(pair)]};
+            if (is_msb) {
+               const auto follows_msb {state.after_msb};
+               state.msb = mm.value;
+               state.msb_seen = true;
+               state.after_msb = true;
+               if (state.paired) {
+                  if (!follows_msb) { return; } /* its LSB carries the value */
+                  state.paired = false;
+               }
+            }
+            else if (state.msb_seen) {
+               state.lsb = mm.value;
+               state.lsb_seen = true;
+               if (state.after_msb) { state.paired = true; }
+               state.after_msb = false;
+            }
+            else {
+               ++counter.out;
+               std::forward<Next>(next)(mm);
+               return;
+            }
+            const auto low {state.lsb_seen ? state.lsb : state.msb};
+            mm = MidiMessage {MessageType::kCc, mm.GetChannel().Get(), kCc14BitBase + pair,
+                (state.msb << 7) | low};
+         }
+         ++counter.out;
+         std::forward<Next>(next)(mm);
+      }
+
+      StageCounter counter {};
+
+    private:
+      struct PairState {
+         int msb {0};
+         int lsb {0};
+         bool msb_seen {false};
+         bool lsb_seen {false};
+         bool after_msb {false}; /* the last message for this pair was its MSB */
+         bool paired {false};    /* sends its LSB after its MSB */
+      };
+
+      std::array<std::array<PairState, kCc14BitPairs>, Channel::kCount> state_ {};
+   };
+
+   /*****************************************************************************/
+   /*************MidiPipeline****************************************************/
+   /*****************************************************************************/
+   template<class... Stages> class MidiPipeline {
+    public:
+      template<class Sink> void operator()(MidiMessage mm, Sink&& sink)
+      {
+         Run<0>(mm, sink);
+      }
+
+      /* e.g., "type 120/118, nrpn 118/30" (in/out for each stage) */
+      [[nodiscard]] std::string Counts() const
+      {
+         std::string result;
+         std::apply(
+             [&result](const auto&... stage) {
+                ((result += fmt::format(FMT_STRING("{}{} {}/{}"), result.empty() ? "" : ", ",
+                      stage.kName, stage.counter.in, stage.counter.out)),
+                    ...);
+             },
+             stages_);
+         return result;
+      }
+
+    private:
+      template<std::size_t I, class Sink> void Run(MidiMessage mm, Sink& sink)
+      {
+         if constexpr (I == sizeof...(Stages)) { sink(mm); }
+         else {
+            std::get<I>(stages_)(mm, [this, &sink](MidiMessage out) { Run<I + 1>(out, sink); });
+         }
+      }
+
+      std::tuple<Stages...> stages_ {};
+   };
+
+   using StandardPipeline = MidiPipeline<TypeStage, NrpnStage>;
+   using Cc14BitPipeline = MidiPipeline<TypeStage, NrpnStage, Cc14BitStage>;
+} // namespace rsj
+
+#endif
@@ -16,6 +16,7 @@
 #include "MidiUtilities.h"
 
 #include <exception>
+#include <stdexcept>
 
 #include <gsl/gsl>
 
@@ -26,40 +27,21 @@
 /*****************************************************************************/
 /*************MidiMessage*****************************************************/
 /*****************************************************************************/
-rsj::MidiMessage::MidiMessage(const juce::MidiMessage& mm)
+void rsj::ThrowOutOfRange(const char* what, const int value)
+{
+   throw std::out_of_range(fmt::format(FMT_STRING("MIDI {} out of range: {}."), what, value));
+}
+
+rsj::MidiEvent::MidiEvent(const juce::MidiMessage& mm) noexcept
 {
-   /* anything not set below is set to zero by default constructor */
 #pragma warning(push)
 #pragma warning(disable : 26481) /* doing raw pointer arithmetic, parsing low-level structure */
    // ReSharper disable CppClangTidyCppcoreguidelinesProBoundsPointerArithmetic
    const auto raw {mm.getRawData()};
-   Ensures(raw);
-   if (rsj::ValidMessageType(raw[0])) {
-      message_type_byte = rsj::ToMessageType(raw[0]);
-      channel = raw[0] & 0xF;
-      switch (message_type_byte) {
-      case MessageType::kPw:
-         value = raw[2] << 7 | raw[1];
-         break;
-      case MessageType::kCc:
-      case MessageType::kKeyPressure:
-      case MessageType::kNoteOff:
-      case MessageType::kNoteOn:
-         value = raw[2];
-         control_number = raw[1];
-         break;
-      case MessageType::kPgmChange:
-         control_number = raw[1];
-         break;
-      case MessageType::kChanPressure:
-         value = raw[1];
-         break;
-      case MessageType::kSystem:
-         break; /* no action */
-      }
-   }
-   else {
-      message_type_byte = MessageType::kSystem;
+   const auto size {mm.getRawDataSize()};
+   if (raw && size > 0) {
+      *this = MidiEvent {raw[0], size > 1 ? raw[1] : juce::uint8 {0},
+          size > 2 ? raw[2] : juce::uint8 {0}};
    }
 #pragma warning(pop)
    // ReSharper restore CppClangTidyCppcoreguidelinesProBoundsPointerArithmetic
@@ -72,12 +54,12 @@ NrpnFilter::ProcessResult NrpnFilter::operator()(rsj::MidiMessage message)
 {
    try {
       Expects(message.value <= 0x7F && message.value >= 0);
-      Expects(message.control_number <= 0x7F && message.control_number >= 0);
+      Expects(message.GetControl().Get() <= 0x7F);
       ProcessResult ret_val {false, false, 0, 0};
-      switch (message.control_number) {
+      switch (message.GetControl().Get()) {
       case 6:
          {
-            auto& i_ref {intermediate_results_.at(message.channel)};
+            auto& i_ref {Results(message.GetChannel())};
             if (i_ref.ready_flags_ >= 0b11) {
                ret_val.is_nrpn = true;
                i_ref.value_msb_ = message.value & 0x7F;
@@ -86,14 +68,14 @@ NrpnFilter::ProcessResult NrpnFilter::operator()(rsj::MidiMessage message)
                   ret_val.is_ready = true;
                   ret_val.control = (i_ref.control_msb_ << 7) + i_ref.control_lsb_;
                   ret_val.value = (i_ref.value_msb_ << 7) + i_ref.value_lsb_;
-                  Clear(message.channel);
+                  Clear(message.GetChannel());
                }
             }
          }
          return ret_val;
       case 38:
          {
-            auto& i_ref {intermediate_results_.at(message.channel)};
+            auto& i_ref {Results(message.GetChannel())};
             if (i_ref.ready_flags_ >= 0b11) {
                ret_val.is_nrpn = true;
                i_ref.value_lsb_ = message.value & 0x7F;
@@ -102,7 +84,7 @@ NrpnFilter::ProcessResult NrpnFilter::operator()(rsj::MidiMessage message)
                   ret_val.is_ready = true;
                   ret_val.control = (i_ref.control_msb_ << 7) + i_ref.control_lsb_;
                   ret_val.value = (i_ref.value_msb_ << 7) + i_ref.value_lsb_;
-                  Clear(message.channel);
+                  Clear(message.GetChannel());
                }
             }
          }
@@ -110,7 +92,7 @@ NrpnFilter::ProcessResult NrpnFilter::operator()(rsj::MidiMessage message)
       case 98:
          ret_val.is_nrpn = true;
          {
-            auto& i_ref {intermediate_results_.at(message.channel)};
+            auto& i_ref {Results(message.GetChannel())};
             i_ref.control_lsb_ = message.value & 0x7F;
             i_ref.ready_flags_ |= 0b10;
          }
@@ -118,7 +100,7 @@ NrpnFilter::ProcessResult NrpnFilter::operator()(rsj::MidiMessage message)
       case 99:
          ret_val.is_nrpn = true;
          {
-            auto& i_ref {intermediate_results_.at(message.channel)};
+            auto& i_ref {Results(message.GetChannel())};
             i_ref.control_msb_ = message.value & 0x7F;
             i_ref.ready_flags_ |= 0b1;
          }
@@ -19,7 +19,10 @@
 /* Get the declaration of the primary std::hash template. We are not permitted to declare it
  * ourselves. <typeindex> is guaranteed to provide such a declaration, and is much cheaper to
  * include than <functional>. See https://en.cppreference.com/w/cpp/language/extending_std. */
+#include <algorithm>
 #include <array>
+#include <cstddef>
+#include <cstdint>
 #include <stdexcept>
 #include <type_traits>
 #include <typeindex> /*declaration of std::hash template*/
@@ -120,27 +123,168 @@ template<typename Char> struct fmt::formatter<rsj::MessageType, Char> {
 /*************MidiMessage*****************************************************/
 /*****************************************************************************/
 namespace rsj {
-   /* channel is 0-based in MidiMessage, 1-based in MidiMessageId */
-   struct MidiMessage {
+   class MidiMessage;
+
+   [[noreturn]] void ThrowOutOfRange(const char* what, int value);
+
+   /* Channel and control numbers are checked once, when a message enters the program, and then
+    * carried as Channel and Control. Code holding one indexes per-channel and per-control tables
+    * without further checks. */
+   class Channel {
+    public:
+      static constexpr int kCount {16};
+
+      constexpr explicit Channel(int zero_based) : value_ {zero_based}
+      {
+         if (zero_based < 0 || zero_based >= kCount) { ThrowOutOfRange("channel", zero_based); }
+      }
+
+      [[nodiscard]] constexpr int Get() const noexcept { return value_; }
+
+      [[nodiscard]] constexpr size_t Index() const noexcept
+      {
+         return static_cast<size_t>(value_);
+      }
+
+    private:
+      friend class MidiMessage;
+      struct Unchecked {};
+
+      constexpr Channel(int zero_based, Unchecked) noexcept : value_ {zero_based} {}
+
+      int value_;
+   };
+
+   /* CC and note numbers 0-0x7F, NRPN numbers 0x80-0x3FFF */
+   class Control {
+    public:
+      static constexpr int kCount {0x4000};
+
+      constexpr explicit Control(int number) : value_ {number}
+      {
+         if (number < 0 || number >= kCount) { ThrowOutOfRange("control number", number); }
+      }
+
+      [[nodiscard]] constexpr int Get() const noexcept { return value_; }
+
+      [[nodiscard]] constexpr size_t Index() const noexcept
+      {
+         return static_cast<size_t>(value_);
+      }
+
+      [[nodiscard]] constexpr bool IsNrpn() const noexcept { return value_ > 0x7F; }
+
+    private:
+      friend class MidiMessage;
+      struct Unchecked {};
+
+      constexpr Control(int number, Unchecked) noexcept : value_ {number} {}
+
+      int value_;
+   };
+
+   /* A MIDI message as received, packed into 32 bits: status byte and two data bytes. Each input
+    * device has its own queue, so the device needn't be recorded. Input queues hold these, 16 to a
+    * cache line, and the message is decoded into a MidiMessage on the dispatch thread. */
+   class MidiEvent {
+    public:
+      constexpr MidiEvent() noexcept = default;
+
+      constexpr MidiEvent(uint8_t status, uint8_t data1, uint8_t data2) noexcept
+          : packed_ {static_cast<uint32_t>(status) | static_cast<uint32_t>(data1 & 0x7F) << 8
+                     | static_cast<uint32_t>(data2 & 0x7F) << 16}
+      {
+      }
+
+      explicit MidiEvent(const juce::MidiMessage& mm) noexcept;
+
+      [[nodiscard]] constexpr uint8_t Status() const noexcept { return Byte(0); }
+
+      [[nodiscard]] constexpr uint8_t Data1() const noexcept { return Byte(1); }
+
+      [[nodiscard]] constexpr uint8_t Data2() const noexcept { return Byte(2); }
+
+      [[nodiscard]] constexpr bool operator==(const MidiEvent& other) const noexcept = default;
+
+    private:
+      [[nodiscard]] constexpr uint8_t Byte(int n) const noexcept
+      {
+         return static_cast<uint8_t>(packed_ >> (8 * n) & 0xFFU);
+      }
+
+      uint32_t packed_ {0};
+   };
+
+   static_assert(sizeof(MidiEvent) == 4);
+
+   /* channel is 0-based in MidiMessage, 1-based in MidiMessageId. Channel and control number are
+    * validated by the constructors and can't be changed afterwards, so GetChannel and GetControl
+    * don't check them again. */
+   class MidiMessage {
+    public:
       MessageType message_type_byte {MessageType::kNoteOn};
-      int channel {0}; /* 0-based */
-      int control_number {0};
       int value {0};
       constexpr MidiMessage() noexcept = default;
 
-      constexpr MidiMessage(MessageType mt, int ch, int nu, int va) noexcept
-          : message_type_byte(mt), channel(ch), control_number(nu), value(va)
+      constexpr MidiMessage(MessageType mt, int ch, int nu, int va)
+          : message_type_byte(mt), value(va), channel_(Channel(ch).Get()),
+            control_number_(Control(nu).Get())
       {
       }
 
-      explicit MidiMessage(const juce::MidiMessage& mm);
-   };
+      /* status and data bytes of a MidiEvent are always in range, so this doesn't check */
+      explicit constexpr MidiMessage(MidiEvent event) noexcept
+      {
+         /* anything not set below is set to zero by default constructor */
+         const auto status {event.Status()};
+         if (!ValidMessageType(status)) {
+            message_type_byte = MessageType::kSystem;
+            return;
+         }
+         message_type_byte = static_cast<MessageType>(status >> 4U);
+         channel_ = status & 0xF;
+         switch (message_type_byte) {
+         case MessageType::kPw:
+            value = event.Data2() << 7 | event.Data1();
+            break;
+         case MessageType::kCc:
+         case MessageType::kKeyPressure:
+         case MessageType::kNoteOff:
+         case MessageType::kNoteOn:
+            value = event.Data2();
+            control_number_ = event.Data1();
+            break;
+         case MessageType::kPgmChange:
+            control_number_ = event.Data1();
+            break;
+         case MessageType::kChanPressure:
+            value = event.Data1();
+            break;
+         case MessageType::kSystem:
+            break; /* no action */
+         }
+      }
 
-   constexpr bool operator==(rsj::MidiMessage lhs, rsj::MidiMessage rhs) noexcept
-   {
-      return lhs.message_type_byte == rhs.message_type_byte && lhs.channel == rhs.channel
-             && lhs.control_number == rhs.control_number && lhs.value == rhs.value;
-   }
+      [[nodiscard]] constexpr Channel GetChannel() const noexcept
+      {
+         return {channel_, Channel::Unchecked {}};
+      }
+
+      [[nodiscard]] constexpr Control GetControl() const noexcept
+      {
+         return {control_number_, Control::Unchecked {}};
+      }
+
+      [[nodiscard]] constexpr bool operator==(const MidiMessage& other) const noexcept
+      {
+         return message_type_byte == other.message_type_byte && channel_ == other.channel_
+                && control_number_ == other.control_number_ && value == other.value;
+      }
+
+    private:
+      int channel_ {0}; /* 0-based */
+      int control_number_ {0};
+   };
 
    /* channel is 0-based in MidiMessage, 1-based in MidiMessageId */
    struct MidiMessageId {
@@ -156,10 +300,24 @@ namespace rsj {
       }
 
       explicit constexpr MidiMessageId(const MidiMessage& other) noexcept
-          : channel {other.channel + 1}, control_number {other.control_number},
+          : channel {other.GetChannel().Get() + 1}, control_number {other.GetControl().Get()},
             msg_id_type {other.message_type_byte}
       {
       }
+
+      /* type, channel and control number packed into 32 bits, for lookups and hashing. Distinct for
+       * all valid ids. */
+      [[nodiscard]] constexpr uint32_t Key() const noexcept
+      {
+         return static_cast<uint32_t>(msg_id_type) << 24
+                | static_cast<uint32_t>(channel & 0xFF) << 16
+                | static_cast<uint32_t>(control_number & 0xFFFF);
+      }
+
+      /* ids come from profiles and Lightroom as well as from MIDI input, so these check */
+      [[nodiscard]] constexpr Channel GetChannel() const { return Channel(channel - 1); }
+
+      [[nodiscard]] constexpr Control GetControl() const { return Control(control_number); }
 #ifdef __cpp_lib_three_way_comparison
       [[nodiscard]] constexpr std::strong_ordering operator<=>(
           const MidiMessageId& other) const noexcept = default;
@@ -190,14 +348,21 @@ namespace rsj {
  * specialization satisfies all requirements for the original template, except where such
  * specializations are prohibited. */
 template<> struct std::hash<rsj::MidiMessageId> {
-   size_t operator()(rsj::MidiMessageId k) const noexcept
+   size_t operator()(rsj::MidiMessageId k) const noexcept { return hash<uint32_t>()(k.Key()); }
+};
+
+namespace rsj {
+   /* 14-bit CC pairs (MSB on CC 0-31, LSB on CC 32-63) are reported as a single message using the
+    * top 32 NRPN numbers, kCc14BitBase + MSB controller number, so ChannelModel gives them the NRPN
+    * (14-bit) range. Those NRPN numbers can't be used by devices when pair decoding is on. */
+   inline constexpr int kCc14BitBase {0x3FE0};
+   inline constexpr int kCc14BitPairs {32};
+
+   [[nodiscard]] constexpr bool IsCc14Bit(int control_number) noexcept
    {
-      /* channel is one byte, messagetype is one byte, controller (data) is two bytes */
-      return hash<int_fast32_t>()(static_cast<int_fast32_t>(k.channel)
-                                  | static_cast<int_fast32_t>(k.msg_id_type) << 8
-                                  | static_cast<int_fast32_t>(k.control_number) << 16);
+      return control_number >= kCc14BitBase && control_number < kCc14BitBase + kCc14BitPairs;
    }
-};
+} // namespace rsj
 
 /*****************************************************************************/
 /*************NrpnFilter******************************************************/
@@ -218,13 +383,6 @@ class NrpnFilter {
    ProcessResult operator()(rsj::MidiMessage message);
 
  private:
-   void Clear(int channel) noexcept
-   {
-#pragma warning(suppress : 26446 26482) /* Channel bounds-checked in calling functions */
-      // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
-      intermediate_results_[channel] = {0, 0, 0, 0, 0};
-   }
-
    struct InternalStructure {
       int control_lsb_ {0};
       int control_msb_ {0};
@@ -233,8 +391,16 @@ class NrpnFilter {
       int value_msb_ {0};
    };
 
-   static constexpr int kChannels {16};
-   std::array<InternalStructure, kChannels> intermediate_results_ {};
+   [[nodiscard]] InternalStructure& Results(rsj::Channel channel) noexcept
+   {
+#pragma warning(suppress : 26446 26482) /* rsj::Channel is always in range */
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+      return intermediate_results_[channel.Index()];
+   }
+
+   void Clear(rsj::Channel channel) noexcept { Results(channel) = {0, 0, 0, 0, 0}; }
+
+   std::array<InternalStructure, rsj::Channel::kCount> intermediate_results_ {};
 };
 
 #endif
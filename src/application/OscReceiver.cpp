@@ -0,0 +1,285 @@
+/*
+ * This file is part of MIDI2LR. Copyright (C) 2015 by Rory Jaffe.
+ *
+ * MIDI2LR is free software: you can redistribute it and/or modify it under the terms of the GNU
+ * General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * MIDI2LR is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with MIDI2LR.  If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "OscReceiver.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include <fmt/format.h>
+#include <gsl/gsl>
+
+#include "EventTap.h"
+#include "MIDIReceiver.h"
+#include "MidiUtilities.h"
+#include "Misc.h"
+
+using namespace std::literals::string_view_literals;
+
+namespace {
+   constexpr size_t kMaxPacket {1536}; /* covers an Ethernet frame; OSC over UDP isn't fragmented */
+   constexpr int kMaxBundleDepth {4};
+   constexpr int kMaxMidi {0x7F};
+   constexpr int kMax14Bit {0x3FFF};
+   constexpr auto kAddressPrefix {"/midi2lr/"sv};
+   constexpr auto kBundleTag {"#bundle\0"sv};
+
+   /* OSC numbers are big-endian. Caller checks that data holds at least four bytes */
+   [[nodiscard]] uint32_t ReadUint32(std::span<const char> data) noexcept
+   {
+      uint32_t result {0};
+      for (const auto byte : data.first(4)) {
+         result = result << 8U | static_cast<uint32_t>(static_cast<unsigned char>(byte));
+      }
+      return result;
+   }
+
+   /* OSC strings are NUL-terminated and padded with NULs to a multiple of four bytes. Removes the
+    * string from the front of data */
+   [[nodiscard]] std::optional<std::string_view> ReadString(std::span<const char>& data) noexcept
+   {
+      const auto end {std::find(data.begin(), data.end(), '\0')};
+      if (end == data.end()) { return std::nullopt; }
+      const auto length {gsl::narrow_cast<size_t>(end - data.begin())};
+      const auto padded {(length + 4) & ~size_t {3}};
+      if (padded > data.size()) { return std::nullopt; }
+      const std::string_view result {data.data(), length};
+      data = data.subspan(padded);
+      return result;
+   }
+
+   [[nodiscard]] std::optional<int> ParseNumber(std::string_view text) noexcept
+   {
+      int result {};
+      const auto last {text.data() + text.size()};
+      if (const auto [ptr, ec] {std::from_chars(text.data(), last, result)};
+          ec != std::errc {} || ptr != last) {
+         return std::nullopt;
+      }
+      return result;
+   }
+
+   struct Target {
+      rsj::MessageType type;
+      int channel; /* 1-based, as in the address */
+      int number;
+      int max;          /* largest int argument */
+      int float_number; /* control a float argument goes to */
+      int float_max;    /* value a float argument of 1 is scaled to */
+   };
+
+   /* /midi2lr/<type>/<channel>[/<number>] */
+   [[nodiscard]] std::optional<Target> ParseAddress(std::string_view address) noexcept
+   {
+      if (!address.starts_with(kAddressPrefix)) { return std::nullopt; }
+      address.remove_prefix(kAddressPrefix.size());
+      const auto next_part {[&address] {
+         const auto slash {address.find('/')};
+         const auto part {address.substr(0, slash)};
+         address.remove_prefix(slash == std::string_view::npos ? address.size() : slash + 1);
+         return part;
+      }};
+      const auto type {next_part()};
+      const auto channel {ParseNumber(next_part())};
+      if (!channel || *channel < 1 || *channel > rsj::Channel::kCount) { return std::nullopt; }
+      if (type == "pw"sv) {
+         if (!address.empty()) { return std::nullopt; }
+         return Target {rsj::MessageType::kPw, *channel, 0, kMax14Bit, 0, kMax14Bit};
+      }
+      const auto number {ParseNumber(next_part())};
+      if (!number || *number < 0 || !address.empty()) { return std::nullopt; }
+      if (type == "cc"sv && *number <= kMax14Bit) {
+         if (*number > kMaxMidi) {
+            return Target {
+                rsj::MessageType::kCc, *channel, *number, kMax14Bit, *number, kMax14Bit};
+         }
+         if (*number < rsj::kCc14BitPairs) { /* float as the CC's 14-bit pair, like a device */
+            return Target {rsj::MessageType::kCc, *channel, *number, kMaxMidi,
+                rsj::kCc14BitBase + *number, kMax14Bit};
+         }
+         return Target {rsj::MessageType::kCc, *channel, *number, kMaxMidi, *number, kMaxMidi};
+      }
+      if (type == "note"sv && *number <= kMaxMidi) {
+         return Target {
+             rsj::MessageType::kNoteOn, *channel, *number, kMaxMidi, *number, kMaxMidi};
+      }
+      return std::nullopt;
+   }
+
+   /* address, type tags, then the value from the first argument; other arguments are ignored */
+   [[nodiscard]] std::optional<rsj::MidiMessage> DecodeMessage(std::span<const char> packet)
+   {
+      const auto address {ReadString(packet)};
+      if (!address) { return std::nullopt; }
+      const auto target {ParseAddress(*address)};
+      if (!target) { return std::nullopt; }
+      const auto tags {ReadString(packet)};
+      if (!tags || tags->size() < 2 || tags->front() != ',' || packet.size() < 4) {
+         return std::nullopt;
+      }
+      const auto raw {ReadUint32(packet)};
+      switch (tags->at(1)) {
+      case 'f': {
+         int value {0};
+         if (const auto f {std::bit_cast<float>(raw)}; std::isfinite(f)) {
+            value = gsl::narrow_cast<int>(
+                std::lround(std::clamp(f, 0.F, 1.F) * static_cast<float>(target->float_max)));
+         }
+         return rsj::MidiMessage {target->type, target->channel - 1, target->float_number, value};
+      }
+      case 'i':
+         return rsj::MidiMessage {target->type, target->channel - 1, target->number,
+             std::clamp(static_cast<int>(std::bit_cast<int32_t>(raw)), 0, target->max)};
+      default:
+         return std::nullopt;
+      }
+   }
+
+   /* a bundle's elements are handled in order as soon as it arrives; its time tag is ignored */
+   template<class Dispatch>
+   void ProcessPacket(std::span<const char> packet, const Dispatch& dispatch, int depth)
+   {
+      if (packet.size() >= 16 && std::string_view {packet.data(), 8} == kBundleTag) {
+         if (depth == kMaxBundleDepth) { return; }
+         packet = packet.subspan(16); /* tag and time tag */
+         while (packet.size() >= 4) {
+            const auto size {ReadUint32(packet)};
+            packet = packet.subspan(4);
+            if (size > packet.size() || size % 4 != 0) { return; }
+            ProcessPacket(packet.first(size), dispatch, depth + 1);
+            packet = packet.subspan(size);
+         }
+      }
+      else if (const auto mm {DecodeMessage(packet)}) {
+         dispatch(*mm);
+      }
+   }
+} // namespace
+
+class OscReceiverShared {
+ private:
+   friend OscReceiver;
+   asio::ip::udp::socket socket_;
+   asio::ip::udp::endpoint sender_ {};
+   std::array<char, kMaxPacket> buffer_ {};
+   std::atomic<bool> thread_should_exit_ {false};
+   MidiReceiver& midi_receiver_;
+   static void Receive(std::shared_ptr<OscReceiverShared> osc_receiver_shared);
+
+ public:
+   OscReceiverShared(asio::io_context& io_context, MidiReceiver& midi_receiver)
+       : socket_ {asio::make_strand(io_context)}, midi_receiver_ {midi_receiver}
+   {
+   }
+};
+
+OscReceiver::OscReceiver(MidiReceiver& midi_receiver, asio::io_context& io_context)
+    : osc_receiver_shared_ {std::make_shared<OscReceiverShared>(io_context, midi_receiver)}
+{
+}
+
+void OscReceiver::Start(const int port, const bool remote)
+{
+   try {
+      if (port <= 0 || port > 0xFFFF) { return; }
+      auto& sock {osc_receiver_shared_->socket_};
+      asio::error_code ec;
+      sock.open(asio::ip::udp::v4(), ec);
+      if (!ec) {
+         sock.bind({remote ? asio::ip::address_v4::any() : asio::ip::address_v4::loopback(),
+                       gsl::narrow_cast<asio::ip::port_type>(port)},
+             ec);
+      }
+      if (ec) {
+         rsj::Log(fmt::format(FMT_STRING("OscReceiver couldn't listen on UDP port {}. {}."), port,
+             ec.message()));
+         asio::error_code ec2;
+         sock.close(ec2);
+         return;
+      }
+      rsj::Log(fmt::format(FMT_STRING("OscReceiver listening on UDP port {}, {}."), port,
+          remote ? "all network interfaces" : "this computer only"));
+      OscReceiverShared::Receive(osc_receiver_shared_);
+   }
+   catch (const std::exception& e) {
+      MIDI2LR_E_RESPONSE;
+      throw;
+   }
+}
+
+void OscReceiver::Stop()
+{
+   try {
+      osc_receiver_shared_->thread_should_exit_.store(true, std::memory_order_release);
+      if (auto& sock {osc_receiver_shared_->socket_}; sock.is_open()) {
+         asio::error_code ec;
+         sock.close(ec);
+         if (ec) {
+            rsj::Log(fmt::format(FMT_STRING("OscReceiver socket close error {}."), ec.message()));
+         }
+      }
+   }
+   catch (const std::exception& e) {
+      MIDI2LR_E_RESPONSE;
+      throw;
+   }
+}
+
+void OscReceiverShared::Receive(std::shared_ptr<OscReceiverShared> osc_receiver_shared)
+{
+   try {
+      if (!osc_receiver_shared->thread_should_exit_.load(std::memory_order_acquire)) {
+         auto& shared {*osc_receiver_shared};
+         shared.socket_.async_receive_from(asio::buffer(shared.buffer_), shared.sender_,
+             [osc_receiver_shared](const asio::error_code& error,
+                 const std::size_t bytes_received) mutable {
+                auto& sh {*osc_receiver_shared};
+                if (sh.thread_should_exit_.load(std::memory_order_acquire)
+                    || error == asio::error::operation_aborted) {
+                   return;
+                }
+                if (!error) [[likely]] {
+                   ProcessPacket(std::span<const char>(sh.buffer_.data(), bytes_received),
+                       [&receiver = sh.midi_receiver_](rsj::MidiMessage mm) {
+                          rsj::Tap(rsj::TapKind::kOscIn, mm);
+                          receiver.Dispatch(mm);
+                       },
+                       0);
+                }
+                else { /* e.g., ICMP port unreachable from an earlier send; keep listening */
+                   rsj::Log(fmt::format(FMT_STRING("OscReceiver receive error: {}."),
+                       error.message()));
+                }
+                if (sh.socket_.is_open()) { Receive(std::move(osc_receiver_shared)); }
+             });
+      }
+   }
+   catch (const std::exception& e) {
+      MIDI2LR_E_RESPONSE;
+      throw;
+   }
+}
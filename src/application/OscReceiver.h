@@ -0,0 +1,52 @@
+#ifndef MIDI2LR_OSCRECEIVER_H_INCLUDED
+#define MIDI2LR_OSCRECEIVER_H_INCLUDED
+/*
+ * This file is part of MIDI2LR. Copyright (C) 2015 by Rory Jaffe.
+ *
+ * MIDI2LR is free software: you can redistribute it and/or modify it under the terms of the GNU
+ * General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * MIDI2LR is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with MIDI2LR.  If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <memory>
+
+#include <asio/asio.hpp>
+
+class MidiReceiver;
+class OscReceiverShared;
+
+/* Receives OSC (Open Sound Control) messages over UDP and passes each one to the MidiReceiver
+ * callbacks as the MIDI message it addresses, so OSC controls are learned, mapped and fed back like
+ * MIDI ones. Addresses are /midi2lr/cc/<channel>/<control>, /midi2lr/note/<channel>/<note> and
+ * /midi2lr/pw/<channel>, with channel 1-16. The first argument is the value. An int is used as is.
+ * A float from 0 to 1 is scaled to 0-16383 for the pitch wheel and controls above 127 (the NRPN
+ * range), and on CC 0-31 arrives as that CC's 14-bit pair, as a 14-bit MIDI controller would. On
+ * other CCs and notes it is scaled to 0-127. Bundles are unpacked.
+ *
+ * OSC has no authentication. By default the socket is bound to the loopback interface, so only
+ * programs on this computer can send. With remote on, anyone on the network who can reach the
+ * port can move mapped controls and send mapped commands to Lightroom. */
+class OscReceiver {
+ public:
+   OscReceiver(MidiReceiver& midi_receiver, asio::io_context& io_context);
+   ~OscReceiver() = default;
+   OscReceiver(const OscReceiver& other) = delete;
+   OscReceiver(OscReceiver&& other) = delete;
+   OscReceiver& operator=(const OscReceiver& other) = delete;
+   OscReceiver& operator=(OscReceiver&& other) = delete;
+   /* port 0 leaves OSC input off. Unless remote, only this computer can send */
+   void Start(int port, bool remote);
+   void Stop();
+
+ private:
+   std::shared_ptr<OscReceiverShared> osc_receiver_shared_;
+};
+
+#endif
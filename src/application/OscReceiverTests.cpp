@@ -0,0 +1,198 @@
+/*
+ * This file is part of MIDI2LR. Copyright (C) 2015 by Rory Jaffe.
+ *
+ * MIDI2LR is free software: you can redistribute it and/or modify it under the terms of the GNU
+ * General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * MIDI2LR is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with MIDI2LR.  If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#ifdef MIDI2LR_TESTS
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <initializer_list>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <asio/asio.hpp>
+#include <fmt/format.h>
+
+#include <juce_core/juce_core.h>
+
+#include "Devices.h"
+#include "MIDIReceiver.h"
+#include "MidiUtilities.h"
+#include "OscReceiver.h"
+#include "UnitTests.h"
+
+namespace {
+   using Packet = std::vector<char>;
+
+   /* NUL-terminated, padded with NULs to a multiple of four bytes */
+   void AppendString(Packet& packet, std::string_view text)
+   {
+      packet.insert(packet.end(), text.begin(), text.end());
+      do { packet.push_back('\0'); } while (packet.size() % 4 != 0);
+   }
+
+   void AppendUint32(Packet& packet, uint32_t value) /* big-endian */
+   {
+      for (auto shift {24}; shift >= 0; shift -= 8) {
+         packet.push_back(static_cast<char>(value >> shift & 0xFFU));
+      }
+   }
+
+   [[nodiscard]] Packet FloatMessage(std::string_view address, float value)
+   {
+      Packet packet;
+      AppendString(packet, address);
+      AppendString(packet, ",f");
+      AppendUint32(packet, std::bit_cast<uint32_t>(value));
+      return packet;
+   }
+
+   [[nodiscard]] Packet IntMessage(std::string_view address, int32_t value)
+   {
+      Packet packet;
+      AppendString(packet, address);
+      AppendString(packet, ",i");
+      AppendUint32(packet, std::bit_cast<uint32_t>(value));
+      return packet;
+   }
+
+   [[nodiscard]] Packet Bundle(std::initializer_list<Packet> elements)
+   {
+      Packet packet;
+      AppendString(packet, "#bundle");
+      AppendUint32(packet, 0); /* time tag 1: immediately */
+      AppendUint32(packet, 1);
+      for (const auto& element : elements) {
+         AppendUint32(packet, static_cast<uint32_t>(element.size()));
+         packet.insert(packet.end(), element.begin(), element.end());
+      }
+      return packet;
+   }
+
+   /* collects what the MidiReceiver dispatch thread passes to the callbacks */
+   class Collector {
+    public:
+      void MidiCmdCallback(rsj::MidiMessage mm)
+      {
+         auto lock {std::scoped_lock(mutex_)};
+         messages_.push_back(mm);
+      }
+
+      [[nodiscard]] std::vector<rsj::MidiMessage> Messages() const
+      {
+         auto lock {std::scoped_lock(mutex_)};
+         return messages_;
+      }
+
+    private:
+      mutable std::mutex mutex_;
+      std::vector<rsj::MidiMessage> messages_;
+   };
+
+   [[nodiscard]] std::string Describe(const rsj::MidiMessage& mm)
+   {
+      return fmt::format(FMT_STRING("{} channel {} control {} value {}"), mm.message_type_byte,
+          mm.GetChannel().Get() + 1, mm.GetControl().Get(), mm.value);
+   }
+
+   /* Sends datagrams to OscReceiver over the loopback interface and checks the messages that come
+    * out of MidiReceiver's dispatch, in order. */
+   class OscReceiverLoopbackTest final : public juce::UnitTest {
+    public:
+      OscReceiverLoopbackTest() : juce::UnitTest {"OSC receiver loopback", rsj::kTestCategory} {}
+
+      void runTest() override
+      {
+         beginTest("datagrams to dispatched MIDI messages");
+         using rsj::MessageType;
+         const std::vector<Packet> packets {
+             FloatMessage("/midi2lr/cc/1/64", 1.F),
+             FloatMessage("/midi2lr/cc/2/1", 0.5F), /* 14-bit pair */
+             IntMessage("/midi2lr/cc/1/7", 64),
+             FloatMessage("/midi2lr/cc/16/1000", 0.25F),
+             IntMessage("/midi2lr/note/3/60", 100),
+             FloatMessage("/midi2lr/pw/1", 1.F),
+             IntMessage("/midi2lr/cc/17/1", 1), /* no channel 17 */
+             FloatMessage("/midi2lr/fader/1/1", 1.F), /* unknown type */
+             Bundle({IntMessage("/midi2lr/cc/1/2", 5), IntMessage("/midi2lr/cc/1/3", 6)}),
+         };
+         const std::vector<rsj::MidiMessage> expected {
+             {MessageType::kCc, 0, 64, 127},
+             {MessageType::kCc, 1, rsj::kCc14BitBase + 1, 8192},
+             {MessageType::kCc, 0, 7, 64},
+             {MessageType::kCc, 15, 1000, 4096},
+             {MessageType::kNoteOn, 2, 60, 100},
+             {MessageType::kPw, 0, 0, 0x3FFF},
+             {MessageType::kCc, 0, 2, 5},
+             {MessageType::kCc, 0, 3, 6},
+         };
+         const auto received {SendAll(packets, expected.size())};
+         expectEquals(static_cast<int>(received.size()), static_cast<int>(expected.size()),
+             "wrong number of messages dispatched");
+         for (size_t i {0}; i < received.size() && i < expected.size(); ++i) {
+            expect(received[i] == expected[i],
+                fmt::format(FMT_STRING("message {}: got {}, expected {}"), i,
+                    Describe(received[i]), Describe(expected[i])));
+         }
+      }
+
+    private:
+      [[nodiscard]] static asio::ip::port_type FreePort(asio::io_context& io_context)
+      {
+         asio::ip::udp::socket probe {io_context,
+             asio::ip::udp::endpoint {asio::ip::address_v4::loopback(), 0}};
+         return probe.local_endpoint().port();
+      }
+
+      /* returns what was dispatched once count messages arrive, or after a timeout */
+      [[nodiscard]] static std::vector<rsj::MidiMessage> SendAll(const std::vector<Packet>& packets,
+          size_t count)
+      {
+         asio::io_context io_context;
+         auto work {asio::make_work_guard(io_context)};
+         std::thread io_thread {[&io_context] { io_context.run(); }};
+         Devices devices;
+         MidiReceiver midi_receiver {devices};
+         Collector collector;
+         midi_receiver.AddCallback(&collector, &Collector::MidiCmdCallback);
+         midi_receiver.StartHeadless();
+         OscReceiver osc_receiver {midi_receiver, io_context};
+         const auto port {FreePort(io_context)};
+         osc_receiver.Start(port, false);
+
+         asio::ip::udp::socket sender {io_context, asio::ip::udp::v4()};
+         const asio::ip::udp::endpoint destination {asio::ip::address_v4::loopback(), port};
+         for (const auto& packet : packets) { sender.send_to(asio::buffer(packet), destination); }
+
+         const auto give_up {std::chrono::steady_clock::now() + std::chrono::seconds(5)};
+         while (collector.Messages().size() < count
+                && std::chrono::steady_clock::now() < give_up) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+         }
+         std::this_thread::sleep_for(std::chrono::milliseconds(50)); /* anything unexpected */
+         osc_receiver.Stop();
+         midi_receiver.Stop();
+         work.reset();
+         io_context.stop();
+         io_thread.join();
+         return collector.Messages();
+      }
+   };
+
+   OscReceiverLoopbackTest osc_receiver_loopback_test; /* registers itself with juce::UnitTest */
+} // namespace
+#endif
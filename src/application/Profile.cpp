@@ -18,6 +18,9 @@
 #include <exception>
 #include <memory>
 #include <ranges>
+#include <utility>
+
+#include <juce_events/juce_events.h>
 
 #include "Misc.h"
 
@@ -30,6 +33,49 @@ namespace {
        {"Resetlocal_Whites2012",    "Resetlocal_Whites"},
        {"Resetlocal_Blacks2012",    "Resetlocal_Blacks"}
    };
+
+   /* builds the XML off any lock and writes it to a temporary file that is renamed over the target,
+    * so a failed write leaves the old file intact */
+   bool WriteXml(const Profile::Rows& table, const juce::File& file)
+   {
+      juce::XmlElement root {"settings"};
+      for (const auto& [msg_id, cmd_str] : table) {
+         auto setting {std::make_unique<juce::XmlElement>("setting")};
+         setting->setAttribute("channel", msg_id.channel);
+         switch (msg_id.msg_id_type) {
+         case rsj::MessageType::kNoteOn:
+            setting->setAttribute("note", msg_id.control_number);
+            break;
+         case rsj::MessageType::kCc:
+            setting->setAttribute("controller", msg_id.control_number);
+            break;
+         case rsj::MessageType::kPw:
+            setting->setAttribute("pitchbend", 0);
+            break;
+         case rsj::MessageType::kChanPressure:
+         case rsj::MessageType::kKeyPressure:
+         case rsj::MessageType::kNoteOff:
+         case rsj::MessageType::kPgmChange:
+         case rsj::MessageType::kSystem:
+            /* can't handle other types */
+            continue;
+         }
+         setting->setAttribute("command_string", cmd_str);
+         /* prepend is constant time, append walks the child list */
+         root.prependChildElement(setting.release());
+      }
+      const juce::TemporaryFile temp {file};
+      if (!root.writeTo(temp.getFile()) || !temp.overwriteTargetFileWithTemporary()) {
+         /* Give feedback if file-save doesn't work */
+         const auto& p {file.getFullPathName()};
+         rsj::LogAndAlertError(juce::translate("Unable to save file. Choose a different "
+                                               "location and try again.")
+                                   + ' ' + p,
+             "Unable to save file. Choose a different location and try again. " + p);
+         return false;
+      }
+      return true;
+   }
 } // namespace
 
 void Profile::FromXml(const juce::XmlElement* root)
@@ -99,12 +145,13 @@ std::vector<rsj::MidiMessageId> Profile::GetMessagesForCommand(const std::string
 void Profile::InsertOrAssignI(const std::string& command, const rsj::MidiMessageId& message)
 {
    try {
-      const auto found = std::ranges::find(mm_abbrv_table_, message, &mm_abbrv_lmnt_t::first);
+      const auto found = std::ranges::find(mm_abbrv_table_, message.Key(), &KeyOf);
       if (found != mm_abbrv_table_.end()) { found->second = command; }
       else {
          mm_abbrv_table_.emplace_back(message, command);
       }
       SortI();
+      TableChangedI();
       profile_unsaved_ = true;
    }
    catch (const std::exception& e) {
@@ -120,6 +167,7 @@ void Profile::InsertUnassigned(rsj::MidiMessageId message)
       if (!MessageExistsInMapI(message)) {
          mm_abbrv_table_.emplace_back(message, CommandSet::kUnassigned);
          SortI();
+         TableChangedI();
          profile_unsaved_ = true;
       }
    }
@@ -136,6 +184,7 @@ void Profile::RemoveAllRows()
       mm_abbrv_table_.clear();
       /*avoid repeated allocations when building*/
       mm_abbrv_table_.reserve(128);
+      TableChangedI();
       /* no reason for profile_unsaved_ here. nothing to save */
       profile_unsaved_ = false;
    }
@@ -149,9 +198,10 @@ void Profile::RemoveMessage(rsj::MidiMessageId message)
 {
    try {
       auto guard {std::unique_lock {mutex_}};
-      const auto found = std::ranges::find(mm_abbrv_table_, message, &mm_abbrv_lmnt_t::first);
+      const auto found = std::ranges::find(mm_abbrv_table_, message.Key(), &KeyOf);
       if (found != mm_abbrv_table_.end()) [[likely]] {
          mm_abbrv_table_.erase(found);
+         TableChangedI();
          profile_unsaved_ = true;
       }
       else {
@@ -171,6 +221,7 @@ void Profile::RemoveRow(const size_t row)
    try {
       auto guard {std::unique_lock {mutex_}};
       mm_abbrv_table_.erase(mm_abbrv_table_.begin() + gsl::narrow_cast<std::ptrdiff_t>(row));
+      TableChangedI();
       profile_unsaved_ = true;
    }
    catch (const std::exception& e) {
@@ -185,6 +236,7 @@ void Profile::RemoveUnassignedMessages()
       auto guard {std::unique_lock {mutex_}};
       if (std::erase_if(mm_abbrv_table_,
               [](const auto& p) { return p.second == CommandSet::kUnassigned; })) {
+         TableChangedI();
          profile_unsaved_ = true;
       }
    }
@@ -200,6 +252,19 @@ void Profile::Resort(const std::pair<int, bool> new_order)
       auto guard {std::unique_lock {mutex_}};
       current_sort_ = new_order;
       SortI();
+      TableChangedI();
+   }
+   catch (const std::exception& e) {
+      MIDI2LR_E_RESPONSE;
+      throw;
+   }
+}
+
+std::pair<uint64_t, Profile::Rows> Profile::Snapshot() const
+{
+   try {
+      auto guard {std::shared_lock {mutex_}};
+      return {version_.load(std::memory_order_relaxed), mm_abbrv_table_};
    }
    catch (const std::exception& e) {
       MIDI2LR_E_RESPONSE;
@@ -233,52 +298,57 @@ void Profile::SortI()
 
 void Profile::ToXmlFile(const juce::File& file)
 {
-   try { /* except for saved_mm_abbrv_table_ and profile_unsaved_, doesn't alter anything, so to
-            allow for better responsiveness in slow serialization and file write, use shared_lock +
-            mtx solely guarding the two members that are overwritten */
+   try {
+      auto [version, table] {Snapshot()};
+      /* don't bother if map is empty */
+      if (!table.empty() && WriteXml(table, file)) { MarkSaved(version, std::move(table)); }
+   }
+   catch (const std::exception& e) {
+      MIDI2LR_E_RESPONSE;
+      throw;
+   }
+}
+
+void Profile::ToXmlFileAsync(const juce::File& file, std::function<void(bool)> on_done)
+{
+   try {
+      auto [version, table] {Snapshot()};
+      if (table.empty()) { return; }
+      /* chain onto any save still running, so files are written in call order */
+      save_ = std::async(std::launch::async,
+          [this, file, version, table = std::move(table), on_done = std::move(on_done),
+              previous = std::move(save_)]() mutable {
+             rsj::LabelThread(MIDI2LR_UC_LITERAL("Profile save thread"));
+             if (previous.valid()) { previous.wait(); }
+             auto saved {false};
+             try {
+                saved = WriteXml(table, file);
+                if (saved) { MarkSaved(version, std::move(table)); }
+             }
+             catch (const std::exception& e) {
+                MIDI2LR_E_RESPONSE;
+             }
+             if (on_done) {
+                juce::MessageManager::callAsync(
+                    [on_done = std::move(on_done), saved] { on_done(saved); });
+             }
+          });
+   }
+   catch (const std::exception& e) {
+      MIDI2LR_E_RESPONSE;
+      throw;
+   }
+}
+
+void Profile::MarkSaved(const uint64_t version, Rows&& table)
+{
+   try {
       auto abbrv_lock {std::scoped_lock {saved_table_mtx_}};
       auto guard {std::shared_lock {mutex_}};
-      /* don't bother if map is empty */
-      if (!mm_abbrv_table_.empty()) {
-         /* save the contents of the command map to an xml file */
-         juce::XmlElement root {"settings"};
-         for (const auto& [msg_id, cmd_str] : mm_abbrv_table_) {
-            auto setting {std::make_unique<juce::XmlElement>("setting")};
-            setting->setAttribute("channel", msg_id.channel);
-            switch (msg_id.msg_id_type) {
-            case rsj::MessageType::kNoteOn:
-               setting->setAttribute("note", msg_id.control_number);
-               break;
-            case rsj::MessageType::kCc:
-               setting->setAttribute("controller", msg_id.control_number);
-               break;
-            case rsj::MessageType::kPw:
-               setting->setAttribute("pitchbend", 0);
-               break;
-            case rsj::MessageType::kChanPressure:
-            case rsj::MessageType::kKeyPressure:
-            case rsj::MessageType::kNoteOff:
-            case rsj::MessageType::kPgmChange:
-            case rsj::MessageType::kSystem:
-               /* can't handle other types */
-               continue;
-            }
-            setting->setAttribute("command_string", cmd_str);
-            root.prependChildElement(setting.release());
-         }
-         if (!root.writeTo(file)) {
-            /* Give feedback if file-save doesn't work */
-            const auto& p {file.getFullPathName()};
-            rsj::LogAndAlertError(juce::translate("Unable to save file. Choose a different "
-                                                  "location and try again.")
-                                      + ' ' + p,
-                "Unable to save file. Choose a different location and try again. " + p);
-         }
-         else {
-            /*could use shared_mutex above if it were upgradable to unique here*/
-            saved_mm_abbrv_table_ = mm_abbrv_table_;
-            profile_unsaved_ = false;
-         }
+      /* if the rows changed after the snapshot, what was written is not what is in memory */
+      if (version_.load(std::memory_order_relaxed) == version) {
+         saved_mm_abbrv_table_ = std::move(table);
+         profile_unsaved_ = false;
       }
    }
    catch (const std::exception& e) {
@@ -18,6 +18,10 @@
 //-V813_MINSIZE=13 /* warn if passing structure by value > 12 bytes (3*sizeof(int)) */
 
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <future>
 #include <mutex>
 #include <shared_mutex>
 #include <string>
@@ -30,11 +34,14 @@
 
 #include "CommandSet.h"
 #include "MidiUtilities.h"
+#include "ProfiledMutex.h"
 
 /* All methods with I at end don't include a mutex and are for internal use only. Methods without I
  * do have mutex and could be called by another class */
 class Profile {
  public:
+   using Rows = std::vector<std::pair<rsj::MidiMessageId, std::string>>;
+
    explicit Profile(const CommandSet& command_set) noexcept : command_set_ {command_set} {}
 
    [[nodiscard]] bool CommandHasAssociatedMessage(const std::string& command) const;
@@ -55,24 +62,50 @@ class Profile {
    void RemoveUnassignedMessages();
    void Resort(std::pair<int, bool> new_order);
    [[nodiscard]] size_t Size() const;
+   /* copy of all rows, with the Version they were taken at */
+   [[nodiscard]] std::pair<uint64_t, Rows> Snapshot() const;
+   /* both save a snapshot of the rows, taken under the lock, so MIDI processing isn't held up by
+    * the write. ToXmlFile returns when written. ToXmlFileAsync writes on a worker thread, in call
+    * order, then calls on_done(saved) on the message thread */
    void ToXmlFile(const juce::File& file);
+   void ToXmlFileAsync(const juce::File& file, std::function<void(bool)> on_done);
+
+   /* changes whenever rows are added, removed, reassigned or reordered */
+   [[nodiscard]] uint64_t Version() const noexcept
+   {
+      return version_.load(std::memory_order_acquire);
+   }
 
  private:
-   using mm_abbrv_lmnt_t = std::pair<rsj::MidiMessageId, std::string>;
+   using mm_abbrv_lmnt_t = Rows::value_type;
+
+   /* lookups compare packed keys: Key() is a few shifts per row, then one integer compare, rather
+    * than comparing the three fields */
+   [[nodiscard]] static uint32_t KeyOf(const mm_abbrv_lmnt_t& element) noexcept
+   {
+      return element.first.Key();
+   }
+
+   void MarkSaved(uint64_t version, Rows&& table);
    void InsertOrAssignI(const std::string& command, const rsj::MidiMessageId& message);
    [[nodiscard]] bool MessageExistsInMapI(rsj::MidiMessageId message) const;
    void SortI();
 
+   /* call under write lock after changing mm_abbrv_table_ */
+   void TableChangedI() noexcept { version_.fetch_add(1, std::memory_order_release); }
+
    bool profile_unsaved_ {false};
    const CommandSet& command_set_;
    /* access saved_mm_abbrv_table_ and profile_unsaved_ either under write lock mutex_ or lock
     * saved_table_mtx_ with read lock mutex_. Acquire saved_table_mtx_ before read lock attempt on
     * mutex_ */
-   mutable std::mutex saved_table_mtx_;
-   mutable std::shared_mutex mutex_;
+   mutable rsj::ProfiledMutex<"Profile saved table"> saved_table_mtx_;
+   mutable rsj::ProfiledSharedMutex<"Profile"> mutex_;
+   std::atomic<uint64_t> version_ {0};
    std::pair<int, bool> current_sort_ {2, true};
-   std::vector<mm_abbrv_lmnt_t> mm_abbrv_table_ {};
-   std::vector<mm_abbrv_lmnt_t> saved_mm_abbrv_table_ {};
+   Rows mm_abbrv_table_ {};
+   Rows saved_mm_abbrv_table_ {};
+   std::future<void> save_ {}; /* last, so pending save finishes before other members go away */
 };
 
 inline bool Profile::CommandHasAssociatedMessage(const std::string& command) const
@@ -89,7 +122,7 @@ inline bool Profile::CommandHasAssociatedMessage(const std::string& command) con
 inline const std::string& Profile::GetCommandForMessage(rsj::MidiMessageId message) const
 {
    auto guard {std::shared_lock {mutex_}};
-   const auto found = std::ranges::find(mm_abbrv_table_, message, &mm_abbrv_lmnt_t::first);
+   const auto found = std::ranges::find(mm_abbrv_table_, message.Key(), &KeyOf);
    if (found != mm_abbrv_table_.end()) { return found->second; }
    return CommandSet::kUnassigned;
 }
@@ -103,8 +136,8 @@ inline rsj::MidiMessageId Profile::GetMessageForNumber(size_t num) const
 inline int Profile::GetRowForMessage(rsj::MidiMessageId message) const
 {
    auto guard {std::shared_lock {mutex_}};
-   return gsl::narrow_cast<int>(std::ranges::find(mm_abbrv_table_, message, &mm_abbrv_lmnt_t::first)
-                                - mm_abbrv_table_.begin());
+   return gsl::narrow_cast<int>(
+       std::ranges::find(mm_abbrv_table_, message.Key(), &KeyOf) - mm_abbrv_table_.begin());
 }
 
 inline void Profile::InsertOrAssign(const std::string& command, rsj::MidiMessageId message)
@@ -130,9 +163,10 @@ inline bool Profile::MessageExistsInMap(rsj::MidiMessageId message) const
 inline bool Profile::MessageExistsInMapI(rsj::MidiMessageId message) const
 {
 #ifdef __cpp_lib_ranges_contains
-   return std::ranges::contains(mm_abbrv_table_, message, &mm_abbrv_lmnt_t::first);
+   return std::ranges::contains(mm_abbrv_table_, message.Key(), &KeyOf);
 #else
-   return std::ranges::any_of(mm_abbrv_table_, [message](auto& p) { return p.first == message; });
+   return std::ranges::any_of(mm_abbrv_table_,
+       [key {message.Key()}](const auto& p) { return KeyOf(p) == key; });
 #endif
 }
 
@@ -15,6 +15,7 @@
  * see <http://www.gnu.org/licenses/>.
  *
  */
+#include <atomic>
 #include <functional>
 #include <vector>
 
@@ -31,7 +32,7 @@ class Profile;
 #endif
 
 namespace rsj {
-   struct MidiMessage;
+   class MidiMessage;
    struct MidiMessageId;
 } // namespace rsj
 
@@ -82,7 +83,7 @@ class ProfileManager final : juce::AsyncUpdater {
    LrIpcOut& lr_ipc_out_;
    std::vector<juce::String> profiles_;
    std::vector<std::function<void(juce::XmlElement*, const juce::String&)>> callbacks_;
-   SwitchState switch_state_ {SwitchState::kNone};
+   std::atomic<SwitchState> switch_state_ {SwitchState::kNone};
 };
 
 #endif
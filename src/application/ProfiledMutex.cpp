@@ -0,0 +1,135 @@
+/*
+ * This file is part of MIDI2LR. Copyright (C) 2015 by Rory Jaffe.
+ *
+ * MIDI2LR is free software: you can redistribute it and/or modify it under the terms of the GNU
+ * General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * MIDI2LR is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with MIDI2LR.  If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "ProfiledMutex.h"
+
+#include <bit>
+#include <exception>
+#include <ranges>
+#include <vector>
+
+#include <fmt/format.h>
+#include <gsl/gsl>
+
+#include "Misc.h"
+
+namespace {
+   /* LockStats are function statics in InstrumentedMutex, so they outlive anything reporting */
+   std::mutex registry_mutex;
+   std::vector<const rsj::LockStats*> registry;
+
+   /* upper bound of the bucket holding the given fraction of samples, in microseconds */
+   template<class Histogram> uint64_t Percentile(const Histogram& histogram, const double fraction)
+   {
+      uint64_t total {0};
+      for (const auto& bucket : histogram) { total += bucket.load(std::memory_order_relaxed); }
+      if (total == 0) { return 0; }
+      const auto wanted {static_cast<uint64_t>(fraction * static_cast<double>(total))};
+      uint64_t seen {0};
+      for (size_t i {0}; i < histogram.size(); ++i) {
+#pragma warning(suppress : 26446 26482) /* loop bound is array size */
+         seen += histogram[i].load(std::memory_order_relaxed);
+         if (seen > wanted) { return uint64_t {1} << i; }
+      }
+      return uint64_t {1} << (histogram.size() - 1);
+   }
+} // namespace
+
+rsj::LockStats::LockStats(const char* name) : name_ {name}
+{
+   auto lock {std::scoped_lock(registry_mutex)};
+   registry.push_back(this);
+}
+
+void rsj::LockStats::Record(Histogram& histogram, const Clock::duration time) noexcept
+{
+   const auto micros {std::chrono::duration_cast<std::chrono::microseconds>(time).count()};
+   const auto bucket {std::min<size_t>(micros > 0 ? std::bit_width(static_cast<uint64_t>(micros))
+                                                  : 0,
+       kBuckets - 1)};
+#pragma warning(suppress : 26446 26482) /* clamped above */
+   histogram[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+void rsj::LockStats::Acquired(const Clock::duration wait, const bool contended) noexcept
+{
+   acquisitions_.fetch_add(1, std::memory_order_relaxed);
+   if (contended) {
+      contended_.fetch_add(1, std::memory_order_relaxed);
+      wait_ns_.fetch_add(gsl::narrow_cast<uint64_t>(
+                             std::chrono::duration_cast<std::chrono::nanoseconds>(wait).count()),
+          std::memory_order_relaxed);
+   }
+   Record(wait_histogram_, wait);
+}
+
+void rsj::LockStats::Released(const Clock::duration hold) noexcept
+{
+   hold_ns_.fetch_add(gsl::narrow_cast<uint64_t>(
+                          std::chrono::duration_cast<std::chrono::nanoseconds>(hold).count()),
+       std::memory_order_relaxed);
+   Record(hold_histogram_, hold);
+}
+
+std::string rsj::LockStats::Report() const
+{
+   const auto acquisitions {acquisitions_.load(std::memory_order_relaxed)};
+   const auto contended {contended_.load(std::memory_order_relaxed)};
+   return fmt::format(FMT_STRING("{}: {} locks, {} waited ({:.1f}%), total wait {:.3f} ms, wait "
+                                 "p50/p99 <{}/<{} us, total hold {:.3f} ms, hold p50/p99 <{}/<{} "
+                                 "us."),
+       name_, acquisitions, contended,
+       acquisitions ? 100.0 * static_cast<double>(contended) / static_cast<double>(acquisitions)
+                    : 0.0,
+       static_cast<double>(wait_ns_.load(std::memory_order_relaxed)) / 1e6,
+       Percentile(wait_histogram_, 0.5), Percentile(wait_histogram_, 0.99),
+       static_cast<double>(hold_ns_.load(std::memory_order_relaxed)) / 1e6,
+       Percentile(hold_histogram_, 0.5), Percentile(hold_histogram_, 0.99));
+}
+
+std::string rsj::LockContentionReport()
+{
+   try {
+      std::vector<const LockStats*> stats;
+      {
+         auto lock {std::scoped_lock(registry_mutex)};
+         stats = registry;
+      }
+      std::ranges::sort(stats, std::ranges::greater {}, &LockStats::WaitNanoseconds);
+      std::string result;
+      for (const auto* lock_stats : stats) {
+         result += lock_stats->Report();
+         result += '\n';
+      }
+      return result;
+   }
+   catch (const std::exception& e) {
+      MIDI2LR_E_RESPONSE;
+      throw;
+   }
+}
+
+void rsj::LogLockContention() noexcept
+{
+   try {
+      if constexpr (kProfileLocks) {
+         rsj::Log(fmt::format(FMT_STRING("Lock contention, most waiting first:\n{}"),
+             LockContentionReport()));
+      }
+   }
+   catch (const std::exception& e) {
+      MIDI2LR_E_RESPONSE;
+   }
+}
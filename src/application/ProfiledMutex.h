@@ -0,0 +1,170 @@
+#ifndef MIDI2LR_PROFILEDMUTEX_H_INCLUDED
+#define MIDI2LR_PROFILEDMUTEX_H_INCLUDED
+/*
+ * This file is part of MIDI2LR. Copyright (C) 2015 by Rory Jaffe.
+ *
+ * MIDI2LR is free software: you can redistribute it and/or modify it under the terms of the GNU
+ * General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * MIDI2LR is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with MIDI2LR.  If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <type_traits>
+
+/* Define MIDI2LR_PROFILE_LOCKS to make ProfiledMutex and ProfiledSharedMutex record, for each lock
+ * name, how often the lock is taken, how often a thread had to wait, and histograms of wait and
+ * hold times. LockContentionReport ranks the names by total wait. The report is logged at shutdown
+ * and when the plugin sends LockReport, which it does for Generate diagnostic report in the
+ * Lightroom Help menu. Without the define both are plain std::mutex and std::shared_mutex, and the
+ * report is empty. */
+namespace rsj {
+#ifdef MIDI2LR_PROFILE_LOCKS
+   inline constexpr bool kProfileLocks {true};
+#else
+   inline constexpr bool kProfileLocks {false};
+#endif
+
+   /* string literal usable as a template argument: ProfiledMutex<"Profile"> */
+   template<std::size_t N> struct LockName {
+      // NOLINTNEXTLINE(*-avoid-c-arrays)
+      constexpr LockName(const char (&name)[N]) noexcept { std::copy_n(name, N, value); }
+
+      // NOLINTNEXTLINE(*-avoid-c-arrays)
+      char value[N] {};
+   };
+
+   /* Statistics for every lock sharing one name. Histogram bucket 0 is under 1 microsecond, bucket
+    * n is [2^(n-1), 2^n) microseconds, the last bucket collects everything longer. */
+   class LockStats {
+    public:
+      using Clock = std::chrono::steady_clock;
+      static constexpr size_t kBuckets {24};
+
+      explicit LockStats(const char* name); /* registers for LockContentionReport */
+      ~LockStats() = default;
+      LockStats(const LockStats& other) = delete;
+      LockStats(LockStats&& other) = delete;
+      LockStats& operator=(const LockStats& other) = delete;
+      LockStats& operator=(LockStats&& other) = delete;
+
+      void Acquired(Clock::duration wait, bool contended) noexcept;
+      void Released(Clock::duration hold) noexcept;
+      [[nodiscard]] std::string Report() const;
+      [[nodiscard]] uint64_t WaitNanoseconds() const noexcept
+      {
+         return wait_ns_.load(std::memory_order_relaxed);
+      }
+
+    private:
+      using Histogram = std::array<std::atomic<uint64_t>, kBuckets>;
+      static void Record(Histogram& histogram, Clock::duration time) noexcept;
+
+      const char* name_;
+      std::atomic<uint64_t> acquisitions_ {0};
+      std::atomic<uint64_t> contended_ {0};
+      std::atomic<uint64_t> wait_ns_ {0};
+      std::atomic<uint64_t> hold_ns_ {0};
+      Histogram wait_histogram_ {};
+      Histogram hold_histogram_ {};
+   };
+
+   /* one line per lock name, most total wait first */
+   [[nodiscard]] std::string LockContentionReport();
+   void LogLockContention() noexcept;
+
+   /* Meets the same lock requirements as Mutex, so works with scoped_lock, unique_lock,
+    * shared_lock and condition_variable_any. Uncontended locks cost one try_lock and one clock
+    * read. Hold time is measured for exclusive locks only. Shared holders overlap, so one start
+    * time per lock can't describe them. */
+   template<class Mutex, LockName Name> class InstrumentedMutex {
+    public:
+      void lock()
+      {
+         if (mutex_.try_lock()) {
+            acquired_ = LockStats::Clock::now();
+            Stats().Acquired({}, false);
+            return;
+         }
+         const auto start {LockStats::Clock::now()};
+         mutex_.lock();
+         acquired_ = LockStats::Clock::now();
+         Stats().Acquired(acquired_ - start, true);
+      }
+
+      [[nodiscard]] bool try_lock()
+      {
+         if (!mutex_.try_lock()) { return false; }
+         acquired_ = LockStats::Clock::now();
+         Stats().Acquired({}, false);
+         return true;
+      }
+
+      void unlock()
+      {
+         const auto hold {LockStats::Clock::now() - acquired_};
+         mutex_.unlock();
+         Stats().Released(hold);
+      }
+
+      void lock_shared()
+         requires requires(Mutex m) { m.lock_shared(); }
+      {
+         if (mutex_.try_lock_shared()) {
+            Stats().Acquired({}, false);
+            return;
+         }
+         const auto start {LockStats::Clock::now()};
+         mutex_.lock_shared();
+         Stats().Acquired(LockStats::Clock::now() - start, true);
+      }
+
+      [[nodiscard]] bool try_lock_shared()
+         requires requires(Mutex m) { m.try_lock_shared(); }
+      {
+         if (!mutex_.try_lock_shared()) { return false; }
+         Stats().Acquired({}, false);
+         return true;
+      }
+
+      void unlock_shared()
+         requires requires(Mutex m) { m.unlock_shared(); }
+      {
+         mutex_.unlock_shared();
+      }
+
+    private:
+      static LockStats& Stats()
+      {
+         static LockStats stats {Name.value};
+         return stats;
+      }
+
+      Mutex mutex_;
+      LockStats::Clock::time_point acquired_ {}; /* written and read only by the holder */
+   };
+
+   template<LockName Name>
+   using ProfiledMutex =
+       std::conditional_t<kProfileLocks, InstrumentedMutex<std::mutex, Name>, std::mutex>;
+   template<LockName Name>
+   using ProfiledSharedMutex = std::conditional_t<kProfileLocks,
+       InstrumentedMutex<std::shared_mutex, Name>, std::shared_mutex>;
+} // namespace rsj
+
+#endif
@@ -33,10 +33,11 @@
 #include <ww898/utf_converters.hpp>
 
 #include "Misc.h"
+#include "ProfiledMutex.h"
 #include "SendKeys.h"
 
 namespace {
-   std::mutex mutex_sending {};
+   rsj::ProfiledMutex<"SendKeys"> mutex_sending {};
    HWND h_lr_wnd {nullptr};
    std::once_flag of_getlanguage;
 
@@ -15,6 +15,7 @@
  */
 #include "SettingsComponent.h"
 
+#include <algorithm>
 #include <cmath>
 #include <exception>
 
@@ -27,7 +28,7 @@
 namespace {
    constexpr auto kSettingsLeft {20};
    constexpr auto kSettingsWidth {400};
-   constexpr auto kSettingsHeight {300};
+   constexpr auto kSettingsHeight {465};
 } // namespace
 
 SettingsComponent::SettingsComponent(SettingsManager& settings_manager)
@@ -127,6 +128,79 @@ void SettingsComponent::Init()
          rsj::Log(fmt::format(FMT_STRING("Autohide time set to {} seconds."),
              settings_manager_.GetAutoHideTime()));
       };
+
+      /* 14-bit CC */
+      cc14bit_group_.setText(juce::translate("MIDI input"));
+      cc14bit_group_.setBounds(0, 300, kSettingsWidth, 165);
+      addToLayout(&cc14bit_group_, anchorMidLeft, anchorMidRight);
+      addAndMakeVisible(cc14bit_group_);
+
+      cc14bit_enabled_.setToggleState(settings_manager_.GetCc14BitEnabled(),
+          juce::NotificationType::dontSendNotification);
+      cc14bit_enabled_.setTooltip(juce::translate("Takes effect after MIDI2LR is restarted."));
+      cc14bit_enabled_.setBounds(kSettingsLeft, 318, kSettingsWidth - 2 * kSettingsLeft,
+          32); //-V112
+      addToLayout(&cc14bit_enabled_, anchorMidLeft, anchorMidRight);
+      addAndMakeVisible(cc14bit_enabled_);
+      cc14bit_enabled_.onClick = [this] {
+         const auto cc14bit_state {cc14bit_enabled_.getToggleState()};
+         settings_manager_.SetCc14BitEnabled(cc14bit_state);
+         rsj::Log(cc14bit_state ? "14-bit CC pairs set to enabled."
+                                : "14-bit CC pairs set to disabled.");
+      };
+
+      /* OSC input */
+      osc_port_label_.setText(juce::translate("OSC UDP port (0 for none)"),
+          juce::NotificationType::dontSendNotification);
+      osc_port_label_.setBounds(kSettingsLeft, 355, kSettingsWidth / 2, 30);
+      addToLayout(&osc_port_label_, anchorMidLeft, anchorMidRight);
+      addAndMakeVisible(osc_port_label_);
+
+      osc_port_.setInputRestrictions(5, "0123456789");
+      osc_port_.setText(juce::String(settings_manager_.GetOscPort()),
+          juce::NotificationType::dontSendNotification);
+      osc_port_.setTooltip(juce::translate("Takes effect after MIDI2LR is restarted."));
+      osc_port_.setBounds(kSettingsLeft + kSettingsWidth / 2, 358, 80, 24);
+      addToLayout(&osc_port_, anchorMidLeft, anchorMidRight);
+      addAndMakeVisible(osc_port_);
+      osc_port_.onReturnKey = osc_port_.onFocusLost = [this] {
+         const auto port {std::clamp(osc_port_.getText().getIntValue(), 0, 0xFFFF)};
+         settings_manager_.SetOscPort(port);
+         rsj::Log(fmt::format(FMT_STRING("OSC port set to {}."), port));
+      };
+
+      osc_remote_.setToggleState(settings_manager_.GetOscRemote(),
+          juce::NotificationType::dontSendNotification);
+      osc_remote_.setTooltip(juce::translate("Takes effect after MIDI2LR is restarted."));
+      osc_remote_.setBounds(kSettingsLeft, 388, kSettingsWidth - 2 * kSettingsLeft, 32); //-V112
+      addToLayout(&osc_remote_, anchorMidLeft, anchorMidRight);
+      addAndMakeVisible(osc_remote_);
+      osc_remote_.onClick = [this] {
+         const auto osc_remote_state {osc_remote_.getToggleState()};
+         settings_manager_.SetOscRemote(osc_remote_state);
+         rsj::Log(osc_remote_state ? "OSC from other computers set to accepted."
+                                   : "OSC from other computers set to refused.");
+      };
+
+      /* event tap for monitoring tools */
+      event_tap_port_label_.setText(juce::translate("Event tap TCP port (0 for none)"),
+          juce::NotificationType::dontSendNotification);
+      event_tap_port_label_.setBounds(kSettingsLeft, 420, kSettingsWidth / 2, 30);
+      addToLayout(&event_tap_port_label_, anchorMidLeft, anchorMidRight);
+      addAndMakeVisible(event_tap_port_label_);
+
+      event_tap_port_.setInputRestrictions(5, "0123456789");
+      event_tap_port_.setText(juce::String(settings_manager_.GetEventTapPort()),
+          juce::NotificationType::dontSendNotification);
+      event_tap_port_.setTooltip(juce::translate("Takes effect after MIDI2LR is restarted."));
+      event_tap_port_.setBounds(kSettingsLeft + kSettingsWidth / 2, 423, 80, 24);
+      addToLayout(&event_tap_port_, anchorMidLeft, anchorMidRight);
+      addAndMakeVisible(event_tap_port_);
+      event_tap_port_.onReturnKey = event_tap_port_.onFocusLost = [this] {
+         const auto port {std::clamp(event_tap_port_.getText().getIntValue(), 0, 0xFFFF)};
+         settings_manager_.SetEventTapPort(port);
+         rsj::Log(fmt::format(FMT_STRING("Event tap port set to {}."), port));
+      };
       /* turn it on */
       activateLayout();
    }
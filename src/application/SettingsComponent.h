@@ -37,13 +37,21 @@ class SettingsComponent final : public juce::Component, ResizableLayout {
    void paint(juce::Graphics&) override;
 
    juce::GroupComponent autohide_group_ {};
+   juce::GroupComponent cc14bit_group_ {};
    juce::GroupComponent pickup_group_ {};
    juce::GroupComponent profile_group_ {};
    juce::Label autohide_explain_label_ {};
+   juce::Label event_tap_port_label_ {};
+   juce::Label osc_port_label_ {};
    juce::Label pickup_label_ {"PickupLabel", ""};
    juce::Label profile_location_label_ {"Profile Label"};
    juce::Slider autohide_setting_;
+   juce::TextEditor event_tap_port_ {};
+   juce::TextEditor osc_port_ {};
    juce::TextButton profile_location_button_ {juce::translate("Choose Profile Folder")};
+   juce::ToggleButton cc14bit_enabled_ {
+       juce::translate("Combine 14-bit CC pairs (CC 0-31 with CC 32-63)")};
+   juce::ToggleButton osc_remote_ {juce::translate("Accept OSC from other computers")};
    juce::ToggleButton pickup_enabled_ {juce::translate("Enable Pickup Mode")};
    SettingsManager& settings_manager_;
 };
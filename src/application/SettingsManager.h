@@ -39,16 +39,39 @@ class SettingsManager final {
       return properties_file_->getIntValue("autohide", 0);
    }
 
+   [[nodiscard]] bool GetCc14BitEnabled() const noexcept
+   {
+      return properties_file_->getBoolValue("cc14bit_enabled", false);
+   }
+
    [[nodiscard]] juce::String GetDefaultProfile() const noexcept
    {
       return properties_file_->getValue("default_profile");
    }
 
+   /* loopback TCP port for EventTapServer, 0 for none */
+   [[nodiscard]] int GetEventTapPort() const noexcept
+   {
+      return properties_file_->getIntValue("event_tap_port", 0);
+   }
+
    [[nodiscard]] int GetLastVersionFound() const noexcept
    {
       return properties_file_->getIntValue("LastVersionFound", 0);
    }
 
+   /* UDP port for OscReceiver, 0 for none */
+   [[nodiscard]] int GetOscPort() const noexcept
+   {
+      return properties_file_->getIntValue("osc_port", 0);
+   }
+
+   /* false: OscReceiver only listens on the loopback interface */
+   [[nodiscard]] bool GetOscRemote() const noexcept
+   {
+      return properties_file_->getBoolValue("osc_remote", false);
+   }
+
    [[nodiscard]] bool GetPickupEnabled() const noexcept
    {
       return properties_file_->getBoolValue("pickup_enabled", true);
@@ -62,16 +85,24 @@ class SettingsManager final {
    // ReSharper disable CppMemberFunctionMayBeConst
    void SetAutoHideTime(int new_time) { properties_file_->setValue("autohide", new_time); }
 
+   void SetCc14BitEnabled(bool enabled) { properties_file_->setValue("cc14bit_enabled", enabled); }
+
    void SetDefaultProfile(const juce::String& default_profile)
    {
       properties_file_->setValue("default_profile", default_profile);
    }
 
+   void SetEventTapPort(int port) { properties_file_->setValue("event_tap_port", port); }
+
    void SetLastVersionFound(int version_number)
    {
       properties_file_->setValue("LastVersionFound", version_number);
    }
 
+   void SetOscPort(int port) { properties_file_->setValue("osc_port", port); }
+
+   void SetOscRemote(bool remote) { properties_file_->setValue("osc_remote", remote); }
+
    void SetPickupEnabled(bool enabled)
    {
       properties_file_->setValue("pickup_enabled", enabled);
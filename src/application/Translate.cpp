@@ -15,58 +15,44 @@
  */
 #include "Translate.h"
 
+#include <algorithm>
+#include <array>
 #include <exception>
-#include <map>
 #include <memory>
-#include <version>
+#include <string_view>
+
+#include <fmt/format.h>
 
 #include <juce_core/juce_core.h>
 
 #include "Misc.h"
 
-#ifdef __cpp_char8_t
-using TransType = const char8_t*;
-#else
-using TransType = const char*;
-#endif
-
-#include "../../data/application/Translate.txt"
+namespace {
+   /* Each catalog is a separate file in the plugin folder (see tools/translation_work/apptrans.sh),
+    * so only the selected language is read. */
+   constexpr auto kLanguages {std::to_array<std::string_view>({"de", "es", "fr", "hi", "it", "ja",
+       "ko", "nb", "nl", "pl", "pt", "ru", "sv", "th", "zh_cn", "zh_tw"})};
+} // namespace
 
 void rsj::Translate(const std::string& lg)
 {
    try {
-      static const std::map<std::string, TransType> kTranslationTable {
-          {   "de",    de},
-          {   "es",    es},
-          {   "fr",    fr},
-          {   "hi",    hi},
-          {   "it",    it},
-          {   "ja",    ja},
-          {   "ko",    ko},
-          {   "nb",    nb},
-          {   "nl",    nl},
-          {   "pl",    pl},
-          {   "pt",    pt},
-          {   "ru",    ru},
-          {   "sv",    sv},
-          {   "th",    th},
-          {"zh_cn", zh_cn},
-          {"zh_tw", zh_tw}
-      };
       const auto language {rsj::ToLower(lg)};
-      if (const auto found {kTranslationTable.find(language)}; found != kTranslationTable.end()) {
-#pragma warning(suppress : 26490)
-         /* SEE: http://www.open-std.org/jtc1/sc22/wg21/docs/papers/2019/p1423r0.html for rationale
-          * for reinterpret_cast */
-         const juce::String str( // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
-             juce::CharPointer_UTF8(reinterpret_cast<const char*>(found->second)));
-         auto ls {std::make_unique<juce::LocalisedStrings>(str, false)};
-         /* take ownership of ls */
-         juce::LocalisedStrings::setCurrentMappings(ls.release());
+      if (std::find(kLanguages.begin(), kLanguages.end(), language) == kLanguages.end()) {
+         juce::LocalisedStrings::setCurrentMappings(nullptr);
+         return;
       }
-      else {
+      const auto file_name {fmt::format(FMT_STRING("AppTranslation_{}.txt"), language)};
+      const auto file {juce::File::getSpecialLocation(juce::File::currentApplicationFile)
+                           .getSiblingFile(file_name)};
+      if (!file.existsAsFile()) {
+         rsj::Log(fmt::format(FMT_STRING("Translation file {} not found."), file_name));
          juce::LocalisedStrings::setCurrentMappings(nullptr);
+         return;
       }
+      auto ls {std::make_unique<juce::LocalisedStrings>(file, false)};
+      /* take ownership of ls */
+      juce::LocalisedStrings::setCurrentMappings(ls.release());
    }
    catch (const std::exception& e) {
       MIDI2LR_E_RESPONSE_F;
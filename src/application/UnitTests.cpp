@@ -0,0 +1,45 @@
+/*
+ * This file is part of MIDI2LR. Copyright (C) 2015 by Rory Jaffe.
+ *
+ * MIDI2LR is free software: you can redistribute it and/or modify it under the terms of the GNU
+ * General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * MIDI2LR is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with MIDI2LR.  If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "UnitTests.h"
+
+#ifdef MIDI2LR_TESTS
+#include <iostream>
+
+#include <juce_core/juce_core.h>
+
+namespace {
+   class TestRunner final : public juce::UnitTestRunner {
+    private:
+      void logMessage(const juce::String& message) override
+      {
+         std::cout << message << std::endl; // NOLINT(performance-avoid-endl): flush per line
+         juce::UnitTestRunner::logMessage(message);
+      }
+   };
+} // namespace
+
+int rsj::RunUnitTests()
+{
+   TestRunner runner;
+   runner.setAssertOnFailure(false);
+   runner.runTestsInCategory(kTestCategory);
+   int failures {0};
+   for (int i {0}; i < runner.getNumResults(); ++i) {
+      if (const auto* const result {runner.getResult(i)}) { failures += result->failures; }
+   }
+   return failures;
+}
+#endif
@@ -0,0 +1,32 @@
+#ifndef MIDI2LR_UNITTESTS_H_INCLUDED
+#define MIDI2LR_UNITTESTS_H_INCLUDED
+/*
+ * This file is part of MIDI2LR. Copyright (C) 2015 by Rory Jaffe.
+ *
+ * MIDI2LR is free software: you can redistribute it and/or modify it under the terms of the GNU
+ * General Public License as published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * MIDI2LR is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even
+ * the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General
+ * Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with MIDI2LR.  If not,
+ * see <http://www.gnu.org/licenses/>.
+ *
+ */
+/* Unit tests are built only when MIDI2LR_TESTS is defined, see tools/test.sh and tools/test.bat.
+ * The app then runs them instead of starting when given kRunTestsString as its command line, with
+ * no window, MIDI devices or Lightroom connection, and exits with a failure status if any fail.
+ * Test classes derive from juce::UnitTest, use category kTestCategory and are defined as static
+ * instances in the *Tests.cpp files. */
+namespace rsj {
+   inline constexpr auto kRunTestsString {"--run-tests"};
+   inline constexpr auto kTestCategory {"MIDI2LR"};
+
+   /* runs the tests in kTestCategory, reporting to stdout and the log; returns the number of
+    * failed expectations */
+   [[nodiscard]] int RunUnitTests();
+} // namespace rsj
+
+#endif
@@ -777,6 +777,25 @@ LrTasks.startAsyncTask(
 
     local function notsupported() LrDialogs.showBezel(LOC('$$$/MIDI2LR/Dialog/NeedNewerLR=A newer version of Lightroom is required')) end
 
+    -- Commands mapped in the current profile, sent by the app as 'Subscribe a,b,c' whenever the
+    -- profile changes. The change observer only reads these parameters, and only sends crop
+    -- values if a crop command is mapped. Until the first list arrives it checks everything.
+    local Subscribed = {crop = true, lastcrop = {}}
+    local function Subscribe(value)
+      local params, crop = {}, false
+      for command in value:gmatch('[^,%s]+') do
+        if Database.Parameters[command] then
+          params[#params+1] = command
+        end
+        if command:sub(1,4) == 'Crop' then
+          crop = true
+        end
+      end
+      Subscribed.params = params
+      Subscribed.crop = crop
+      Subscribed.lastcrop = {} -- send current crop values once
+    end
+
     local SETTINGS = {
       AppInfo            = function(value) Info.AppInfo[#Info.AppInfo+1] = value end,
       ChangedToDirectory = Profiles.setDirectory,
@@ -806,19 +825,49 @@ LrTasks.startAsyncTask(
           LrSelection.setRating(newrating)
         end
       end,
+      Subscribe          = Subscribe,
     }
 
 
+    -- Values from the app change the catalog, so target photo, module and color grading view are
+    -- read from Lightroom when a value is applied; they can change between two values. Only the
+    -- parameter ranges used by the feedback path are cached, and they are dropped whenever the
+    -- target photo is seen to change, here or in the polling loops below.
+    local LastPhoto = nil
+    local function TargetPhoto()
+      local photo = LrApplication.activeCatalog():getTargetPhoto()
+      local photoid = photo and photo.localIdentifier
+      if photoid ~= LastPhoto then
+        LastPhoto = photoid
+        Limits.ClearRanges()
+      end
+      return photo
+    end
+    local function PhotoSelected()
+      return TargetPhoto() ~= nil
+    end
+    local function EnsureDevelop()
+      if LrApplicationView.getCurrentModuleName() ~= 'develop' then
+        LrApplicationView.switchToModule('develop')
+        LrTasks.yield() -- need this to allow module change before value sent
+      end
+    end
+    local function ShowGradeFocus(gradeFocus)
+      local currentView = LrDevelopController.getActiveColorGradingView()
+      if currentView ~= '3-way' or gradeFocus == 'global' then
+        if currentView ~= gradeFocus then
+          LrDevelopController.setActiveColorGradingView(gradeFocus)
+        end
+      end
+    end
+
     function UpdateParamPickup() --closure
       local paramlastmoved = {}
       local lastfullrefresh = 0
       return function(param, midi_value, silent)
-        if LrApplication.activeCatalog():getTargetPhoto() == nil then return end--unable to update param
+        if not PhotoSelected() then return end--unable to update param
         local value
-        if LrApplicationView.getCurrentModuleName() ~= 'develop' then
-          LrApplicationView.switchToModule('develop')
-          LrTasks.yield() -- need this to allow module change before value sent
-        end
+        EnsureDevelop()
         if Limits.Parameters[param] then
           Limits.ClampValue(param)
         end
@@ -854,12 +903,9 @@ LrTasks.startAsyncTask(
     UpdateParamPickup = UpdateParamPickup() --complete closure
     --called within LrRecursionGuard for setting
     function UpdateParamNoPickup(param, midi_value, silent)
-      if LrApplication.activeCatalog():getTargetPhoto() == nil then return end--unable to update param
+      if not PhotoSelected() then return end--unable to update param
       local value
-      if LrApplicationView.getCurrentModuleName() ~= 'develop' then
-        LrApplicationView.switchToModule('develop')
-        LrTasks.yield() -- need this to allow module change before value sent
-      end
+      EnsureDevelop()
       --Don't need to clamp limited parameters without pickup, as MIDI controls will still work
       --if value is outside limits range
       value = CU.MIDIValueToLRValue(param, midi_value)
@@ -892,43 +938,59 @@ LrTasks.startAsyncTask(
         --call following within guard for reading
         local function AdjustmentChangeObserver()
           local lastrefresh = 0 --will be set to os.clock + increment to rate limit
+          local allparams = {} -- used until the app sends the profile's subscriptions
+          for param in pairs(Database.Parameters) do
+            allparams[#allparams+1] = param
+          end
+          local function addcrop(batch, name, value) -- only values that changed since last sent
+            if Subscribed.lastcrop[name] ~= value then
+              Subscribed.lastcrop[name] = value
+              batch[#batch+1] = string.format('%s %g\n', name, value)
+            end
+          end
           return function(observer) -- closure
             if not sendIsConnected then return end -- can't send
             if Limits.LimitsCanBeSet() and lastrefresh < os.clock() then
-              -- refresh crop values NOTE: this function is repeated in ClientUtilities and Profiles
-              local val_bottom = LrDevelopController.getValue("CropBottom")
-              MIDI2LR.SERVER:send(string.format('CropBottomRight %g\n', val_bottom))
-              MIDI2LR.SERVER:send(string.format('CropBottomLeft %g\n', val_bottom))
-              MIDI2LR.SERVER:send(string.format('CropAll %g\n', val_bottom))
-              MIDI2LR.SERVER:send(string.format('CropBottom %g\n', val_bottom))
-              local val_top = LrDevelopController.getValue("CropTop")
-              MIDI2LR.SERVER:send(string.format('CropTopRight %g\n', val_top))
-              MIDI2LR.SERVER:send(string.format('CropTopLeft %g\n', val_top))
-              MIDI2LR.SERVER:send(string.format('CropTop %g\n', val_top))
-              local val_left = LrDevelopController.getValue("CropLeft")
-              local val_right = LrDevelopController.getValue("CropRight")
-              MIDI2LR.SERVER:send(string.format('CropLeft %g\n', val_left))
-              MIDI2LR.SERVER:send(string.format('CropRight %g\n', val_right))
-              local range_v = (1 - (val_bottom - val_top))
-              if range_v == 0.0 then
-                MIDI2LR.SERVER:send('CropMoveVertical 0\n')
-              else
-                MIDI2LR.SERVER:send(string.format('CropMoveVertical %g\n', val_top / range_v))
-              end
-              local range_h = (1 - (val_right - val_left))
-              if range_h == 0.0 then
-                MIDI2LR.SERVER:send('CropMoveHorizontal 0\n')
-              else
-                MIDI2LR.SERVER:send(string.format('CropMoveHorizontal %g\n', val_left / range_h))
+              local batch = {} -- sent as one write after the loop
+              if Subscribed.crop then
+                -- refresh crop values NOTE: this function is repeated in ClientUtilities and Profiles
+                local val_bottom = LrDevelopController.getValue("CropBottom")
+                addcrop(batch, 'CropBottomRight', val_bottom)
+                addcrop(batch, 'CropBottomLeft', val_bottom)
+                addcrop(batch, 'CropAll', val_bottom)
+                addcrop(batch, 'CropBottom', val_bottom)
+                local val_top = LrDevelopController.getValue("CropTop")
+                addcrop(batch, 'CropTopRight', val_top)
+                addcrop(batch, 'CropTopLeft', val_top)
+                addcrop(batch, 'CropTop', val_top)
+                local val_left = LrDevelopController.getValue("CropLeft")
+                local val_right = LrDevelopController.getValue("CropRight")
+                addcrop(batch, 'CropLeft', val_left)
+                addcrop(batch, 'CropRight', val_right)
+                local range_v = (1 - (val_bottom - val_top))
+                if range_v == 0.0 then
+                  addcrop(batch, 'CropMoveVertical', 0)
+                else
+                  addcrop(batch, 'CropMoveVertical', val_top / range_v)
+                end
+                local range_h = (1 - (val_right - val_left))
+                if range_h == 0.0 then
+                  addcrop(batch, 'CropMoveHorizontal', 0)
+                else
+                  addcrop(batch, 'CropMoveHorizontal', val_left / range_h)
+                end
               end
-              for param in pairs(Database.Parameters) do
+              for _, param in ipairs(Subscribed.params or allparams) do
                 local lrvalue = LrDevelopController.getValue(param)
                 if observer[param] ~= lrvalue and type(lrvalue) == 'number' then --testing for MIDI2LR.SERVER.send kills responsiveness
-                  MIDI2LR.SERVER:send(string.format('%s %g\n', param, CU.LRValueToMIDIValue(param)))
+                  batch[#batch+1] = string.format('%s %g\n', param, CU.LRValueToMIDIValue(param))
                   observer[param] = lrvalue
                   LastParam = param
                 end
               end
+              if #batch > 0 then
+                MIDI2LR.SERVER:send(table.concat(batch))
+              end
               lastrefresh = os.clock() + 0.1 --1/10 sec between refreshes
             end
           end
@@ -969,12 +1031,7 @@ LrTasks.startAsyncTask(
                 UpdateParam(param,tonumber(value),false)
                 local gradeFocus = GradeFocusTable[param]
                 if gradeFocus then
-                  local currentView = LrDevelopController.getActiveColorGradingView()
-                  if currentView ~= '3-way' or gradeFocus == 'global' then
-                    if currentView ~= gradeFocus then
-                      LrDevelopController.setActiveColorGradingView(gradeFocus)
-                    end
-                  end
+                  ShowGradeFocus(gradeFocus)
                 end
               elseif ACTIONS[param] then -- perform a one time action
                 if tonumber(value) > BUTTON_ON then
@@ -1000,12 +1057,7 @@ LrTasks.startAsyncTask(
                     end
                     local gradeFocus = GradeFocusTable[resetparam] -- scroll to correct view on color grading
                     if gradeFocus then
-                      local currentView = LrDevelopController.getActiveColorGradingView()
-                      if currentView ~= '3-way' or gradeFocus == 'global' then
-                        if currentView ~= gradeFocus then
-                          LrDevelopController.setActiveColorGradingView(gradeFocus)
-                        end
-                      end
+                      ShowGradeFocus(gradeFocus)
                     end
                   end
                 end
@@ -1041,6 +1093,7 @@ LrTasks.startAsyncTask(
         while  MIDI2LR.RUNNING and ((LrApplicationView.getCurrentModuleName() ~= 'develop') or (LrApplication.activeCatalog():getTargetPhoto() == nil)) do
           LrTasks.sleep ( .29 )
           Profiles.checkProfile()
+          TargetPhoto()
         end --sleep away until ended or until develop module activated
         LrTasks.sleep ( .2 ) --avoid "attempt to index field 'libraryImage' (a nil value) on fast machines: LR bug
         if MIDI2LR.RUNNING then --didn't drop out of loop because of program termination
@@ -1060,6 +1113,7 @@ LrTasks.startAsyncTask(
           while MIDI2LR.RUNNING do --detect halt or reload
             LrTasks.sleep( .29 )
             Profiles.checkProfile()
+            TargetPhoto()
           end
         end
       end
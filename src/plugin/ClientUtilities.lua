@@ -485,6 +485,7 @@ local function MIDIValueToLRValue(param, midi_value)
   -- map midi range to develop parameter range
   -- expects midi_value 0.0-1.0, doesn't protect against out-of-range
   local min,max = Limits.GetMinMax(param)
+  Limits.ReportRange(param, min, max)
   return midi_value * (max-min) + min
 end
 
@@ -500,6 +501,7 @@ end
 
 local function FullRefresh()
   -- if this code is changed, change similar code in Profiles.lua
+  Limits.ClearReported() -- app may have restarted
   if   (LrApplication.activeCatalog():getTargetPhoto() ~= nil) and
   (LrApplicationView.getCurrentModuleName() == 'develop') then
     -- refresh MIDI controller since mapping has changed
@@ -508,35 +510,43 @@ local function FullRefresh()
         LrMobdebug.on()
         --]]-----------end debug section
         local photoval = LrApplication.activeCatalog():getTargetPhoto():getDevelopSettings()
+        -- lines are collected and sent together, one send per yield
+        local batch = {}
         -- refresh crop values
         local val_bottom = photoval.CropBottom
-        MIDI2LR.SERVER:send(string.format('CropBottomRight %g\n', val_bottom))
-        MIDI2LR.SERVER:send(string.format('CropBottomLeft %g\n', val_bottom))
-        MIDI2LR.SERVER:send(string.format('CropAll %g\n', val_bottom))
-        MIDI2LR.SERVER:send(string.format('CropBottom %g\n', val_bottom))
+        batch[#batch+1] = string.format('CropBottomRight %g\n', val_bottom)
+        batch[#batch+1] = string.format('CropBottomLeft %g\n', val_bottom)
+        batch[#batch+1] = string.format('CropAll %g\n', val_bottom)
+        batch[#batch+1] = string.format('CropBottom %g\n', val_bottom)
         local val_top = photoval.CropTop
-        MIDI2LR.SERVER:send(string.format('CropTopRight %g\n', val_top))
-        MIDI2LR.SERVER:send(string.format('CropTopLeft %g\n', val_top))
-        MIDI2LR.SERVER:send(string.format('CropTop %g\n', val_top))
+        batch[#batch+1] = string.format('CropTopRight %g\n', val_top)
+        batch[#batch+1] = string.format('CropTopLeft %g\n', val_top)
+        batch[#batch+1] = string.format('CropTop %g\n', val_top)
         local val_left = photoval.CropLeft
         local val_right = photoval.CropRight
-        MIDI2LR.SERVER:send(string.format('CropLeft %g\n', val_left))
-        MIDI2LR.SERVER:send(string.format('CropRight %g\n', val_right))
+        batch[#batch+1] = string.format('CropLeft %g\n', val_left)
+        batch[#batch+1] = string.format('CropRight %g\n', val_right)
         local range_v = (1 - (val_bottom - val_top))
         if range_v == 0.0 then
-          MIDI2LR.SERVER:send('CropMoveVertical 0\n')
+          batch[#batch+1] = 'CropMoveVertical 0\n'
         else
-          MIDI2LR.SERVER:send(string.format('CropMoveVertical %g\n', val_top / range_v))
+          batch[#batch+1] = string.format('CropMoveVertical %g\n', val_top / range_v)
         end
         local range_h = (1 - (val_right - val_left))
         if range_h == 0.0 then
-          MIDI2LR.SERVER:send('CropMoveHorizontal 0\n')
+          batch[#batch+1] = 'CropMoveHorizontal 0\n'
         else
-          MIDI2LR.SERVER:send(string.format('CropMoveHorizontal %g\n', val_left / range_h))
+          batch[#batch+1] = string.format('CropMoveHorizontal %g\n', val_left / range_h)
         end
         local sel_mask = LrDevelopController.getSelectedMask()
+        local count = 0
         for param,altparam in pairs(Database.Parameters) do
-          LrTasks.yield()
+          count = count + 1
+          if count % 16 == 0 then
+            MIDI2LR.SERVER:send(table.concat(batch))
+            batch = {}
+            LrTasks.yield()
+          end
           local min,max = Limits.GetMinMax(param)
           local lrvalue
           if altparam == 'Direct' then
@@ -547,14 +557,17 @@ local function FullRefresh()
           if type(min) == 'number' and type(max) == 'number' and type(lrvalue) == 'number' then
             local midivalue = (lrvalue-min)/(max-min)
             if midivalue >= 1.0 then
-              MIDI2LR.SERVER:send(string.format('%s 1.0\n', param))
+              batch[#batch+1] = string.format('%s 1.0\n', param)
             elseif midivalue <= 0.0 then -- = catches -0.0 and sends it as 0.0
-              MIDI2LR.SERVER:send(string.format('%s 0.0\n', param))
+              batch[#batch+1] = string.format('%s 0.0\n', param)
             else
-              MIDI2LR.SERVER:send(string.format('%s %g\n', param, midivalue))
+              batch[#batch+1] = string.format('%s %g\n', param, midivalue)
             end
           end
         end
+        if #batch > 0 then
+          MIDI2LR.SERVER:send(table.concat(batch))
+        end
       end
     )
   end
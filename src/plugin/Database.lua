@@ -1205,6 +1205,7 @@ local function WriteAppTrans(language)
   local GroupOrder={}
   local repeats={}
   local wraps={}
+  local buttons={}
   for _,v in ipairs(DataBase) do
     if CmdStructure[v.Group] then
       table.insert(CmdStructure[v.Group],{v.Command,v.Translation})
@@ -1216,6 +1217,9 @@ local function WriteAppTrans(language)
     if v.Wraps then
       wraps[#wraps+1]=v.Command
     end
+    if v.Type == 'button' then
+      buttons[#buttons+1]=v.Command
+    end
     if v.Repeats and (type(v.Repeats) == 'table') then
       repeats[v.Command] = v.Repeats
     end
@@ -1224,7 +1228,7 @@ local function WriteAppTrans(language)
 <?xml version="1.0" encoding="utf-8"?>
 <cereal>
   <value0>
-    <cereal_class_version>2</cereal_class_version>
+    <cereal_class_version>3</cereal_class_version>
     <language>]=],language,[=[</language>
     <all_commands size="dynamic">
   ]=])
@@ -1260,6 +1264,13 @@ local function WriteAppTrans(language)
   end
   file:write([=[
     </wraps>
+    <buttons size="dynamic">
+]=])
+  for j,v in ipairs(buttons) do
+    file:write('      <value'.. j-1 ..'>'..v..'</value'.. j-1 ..'>\n')
+  end
+  file:write([=[
+    </buttons>
   </value0>
 </cereal>
   ]=])
@@ -20,6 +20,7 @@ MIDI2LR.  If not, see <http://www.gnu.org/licenses/>.
 
 local LrApplication         = import 'LrApplication'
 local LrDialogs             = import 'LrDialogs'
+local LrProgressScope       = import 'LrProgressScope'
 local LrTasks               = import 'LrTasks'
 local LrView                = import 'LrView'
 --[[-----------debug section, enable by adding - to beginning this line
@@ -67,6 +68,33 @@ local function GetKeywords()
   )
 end
 
+local ProgressThreshold = 20 -- show progress for selections larger than this
+
+-- one catalog write transaction for the whole selection, instead of one per photo
+-- action(photo) makes the change to a single photo
+local function WriteToPhotos(LrCat, actionname, photos, action)
+  LrCat:withWriteAccessDo(
+    actionname,
+    function(context)
+      local progress
+      if #photos > ProgressThreshold then
+        progress = LrProgressScope { title = actionname, functionContext = context }
+      end
+      for i,v in ipairs(photos) do
+        action(v)
+        if progress then
+          if progress:isCanceled() then break end
+          progress:setPortionComplete(i, #photos)
+        end
+      end
+      if progress then progress:done() end
+    end,
+    { timeout = 4,
+      callback = function() LrDialogs.showError(LOC("$$$/AgCustomMetadataRegistry/UpdateCatalog/Error=The catalog could not be updated with additional module metadata.")..' '..actionname) end,
+      asynchronous = true }
+  )
+end
+
 local function ApplyKeyword(Keyword)
   LrTasks.startAsyncTask( function(context)
           --[[-----------debug section, enable by adding - to beginning this line
@@ -80,9 +108,8 @@ local function ApplyKeyword(Keyword)
         if ProgramPreferences.ClientShowBezelOnChange then
           LrDialogs.showBezel(LOC("$$$/AgCameraRawNamedSettings/CameraRawSettingMapping/SettingsString/ConstructionWithColon=^1: ^2",LOC("$$$/AgLibrary/AddKeyword=Add Keyword"),LrKeyword:getName()))
         end
-        for _,v in ipairs(TargetPhotos) do
-          LrCat:withWriteAccessDo( 'addKeyword',function( context ) v:addKeyword(LrKeyword) end, { timeout = 2 } )
-        end
+        WriteToPhotos(LrCat, 'MIDI2LR: Add keyword', TargetPhotos,
+          function(v) v:addKeyword(LrKeyword) end)
       end
     end
   )
@@ -101,20 +128,23 @@ local function ToggleKeyword(Keyword)
         if ProgramPreferences.ClientShowBezelOnChange then
           LrDialogs.showBezel(LOC("$$$/AgCameraRawNamedSettings/CameraRawSettingMapping/SettingsString/ConstructionWithColon=^1: ^2",LOC("$$$/MIDI2LR/Keyword/Toggle=Toggle Keyword"),LrKeyword:getName()))
         end
-        for _,v in ipairs(TargetPhotos) do
-          local keyword_enabled = false
-          for _,k in ipairs(v:getRawMetadata('keywords')) do
-            if k.localIdentifier == Keyword then
-              keyword_enabled = true
-              break
+        -- read all keyword lists in one call, before taking write access
+        local photokeywords = LrCat:batchGetRawMetadata(TargetPhotos, {'keywords'})
+        WriteToPhotos(LrCat, 'MIDI2LR: Toggle keyword', TargetPhotos,
+          function(v)
+            local keyword_enabled = false
+            for _,k in ipairs(photokeywords[v].keywords) do
+              if k.localIdentifier == Keyword then
+                keyword_enabled = true
+                break
+              end
             end
-          end
-          if keyword_enabled then
-            LrCat:withWriteAccessDo( 'removeKeyword',function( context ) v:removeKeyword(LrKeyword) end, { timeout = 2 } )
-          else
-            LrCat:withWriteAccessDo( 'addKeyword',function( context ) v:addKeyword(LrKeyword) end, { timeout = 2 } )
-          end
-        end
+            if keyword_enabled then
+              v:removeKeyword(LrKeyword)
+            else
+              v:addKeyword(LrKeyword)
+            end
+          end)
       end
     end
   )
@@ -61,6 +61,19 @@ local function LimitsCanBeSet()
   (LrApplicationView.getCurrentModuleName() == 'develop')
 end
 
+-- LrDevelopController.getRange results for the current photo, cleared by
+-- ClearRanges when the target photo changes
+local ranges = {}
+
+--------------------------------------------------------------------------------
+-- Forgets cached ranges. Call when the target photo changes, as ranges depend
+-- on the photo (e.g., Temperature for raw and non-raw).
+-- @return nil.
+--------------------------------------------------------------------------------
+local function ClearRanges()
+  ranges = {}
+end
+
 --------------------------------------------------------------------------------
 -- Provides min and max for given parameter and mode. Must be called in Develop
 -- module with photo selected.
@@ -69,7 +82,12 @@ end
 -- @return max for given param and mode.
 --------------------------------------------------------------------------------
 local function GetMinMax(param)
-  local low,rangemax = LrDevelopController.getRange(param)
+  local range = ranges[param]
+  if range == nil then
+    range = {LrDevelopController.getRange(param)}
+    ranges[param] = range
+  end
+  local low,rangemax = range[1], range[2]
   if LimitParameters[param] then --should have limits
     if type(ProgramPreferences.Limits[param]) == 'table' and rangemax ~= nil then -- B&W picture may not have temperature, tint. This avoids indexing a nil rangemax and blowing up the metatable _index
       if type(ProgramPreferences.Limits[param][rangemax]) == 'table' then
@@ -86,6 +104,52 @@ local function GetMinMax(param)
   return low, rangemax
 end
 
+--------------------------------------------------------------------------------
+-- Smallest change Lightroom makes to a parameter. For these, ReportRange tells
+-- the app the range and step so it can skip values that round to the Lightroom
+-- value it sent last. Temperature is set in ReportRange, as its step depends on
+-- the photo type. Other parameters are sent at full precision.
+--------------------------------------------------------------------------------
+local ParameterSteps = {
+  Blacks = 1, Clarity = 1, Contrast = 1, Dehaze = 1, Exposure = 0.01, Highlights = 1,
+  Saturation = 1, Shadows = 1, Texture = 1, Tint = 1, Vibrance = 1, Whites = 1,
+}
+for _, color in ipairs {'Aqua','Blue','Green','Magenta','Orange','Purple','Red','Yellow'} do
+  ParameterSteps['HueAdjustment'..color] = 1
+  ParameterSteps['LuminanceAdjustment'..color] = 1
+  ParameterSteps['SaturationAdjustment'..color] = 1
+end
+local reported = {}
+
+--------------------------------------------------------------------------------
+-- Sends 'ParamRange param min max step' to the app when min or max differ from
+-- the last report for param. Called with the results of GetMinMax.
+-- @param param Which parameter is being adjusted.
+-- @param min Current min for param.
+-- @param max Current max for param.
+-- @return nil.
+--------------------------------------------------------------------------------
+local function ReportRange(param, min, max)
+  local step = ParameterSteps[param]
+  if param == 'Temperature' then
+    step = max > 1000 and 50 or 1 -- kelvin for raw photos, -100..100 otherwise
+  end
+  if step == nil then return end
+  local last = reported[param]
+  if last and last[1] == min and last[2] == max then return end
+  reported[param] = {min, max}
+  MIDI2LR.SERVER:send(string.format('ParamRange %s %g %g %g\n', param, min, max, step))
+end
+
+--------------------------------------------------------------------------------
+-- Forgets earlier reports so ReportRange sends again, e.g., after the app
+-- reconnects.
+-- @return nil.
+--------------------------------------------------------------------------------
+local function ClearReported()
+  reported = {}
+end
+
 --------------------------------------------------------------------------------
 -- Limits a given parameter to the min,max set up.
 -- This function is used to avoid the bug in pickup mode, in which the parameter's
@@ -199,9 +263,12 @@ end
 
 return {
   ClampValue  = ClampValue,
+  ClearRanges = ClearRanges,
+  ClearReported = ClearReported,
   EndDialog   = EndDialog,
   GetMinMax   = GetMinMax,
   LimitsCanBeSet = LimitsCanBeSet,
   Parameters  = LimitParameters,
+  ReportRange = ReportRange,
   StartDialog = StartDialog,
 }
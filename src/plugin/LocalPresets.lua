@@ -52,7 +52,9 @@ local LrView        = import 'LrView'
 
 local LocalAdjustmentPresetsPath = LrPathUtils.child(LrPathUtils.getStandardFilePath ('appData') , 'Local Adjustment Presets')
 
-local LocalPresets = {}  --Store presets in table when reqested by user : key = filename, value = preset values table
+--Compiled presets, filled when first applied: key = preset file, value = { modified = file
+--modification date, values = { MappedParam = develop value } }. Reloaded if the file changes.
+local LocalPresets = {}
 
 local localPresetMap = {
   blacks2012 = "local_Blacks",
@@ -93,41 +95,61 @@ local function GetPresetFilenames()
   return filenames
 end
 
+--Returns the develop values for a preset file, reading and compiling it only when it is new or
+--has been modified since last read. Returns nil if the file is missing.
+local function LoadLocalPreset(LocalPresetFilename)
+  local attributes = LrFileUtils.fileAttributes(LocalPresetFilename)
+  local modified = attributes and attributes.fileModificationDate
+  if modified == nil then return nil end
+  local cached = LocalPresets[LocalPresetFilename]
+  if cached and cached.modified == modified then
+    return cached.values
+  end
+  local f = io.open(LocalPresetFilename)
+  if f == nil then return nil end
+  local strPreset = f:read("*a")
+  f:close()
+  --I had to remove 'ZSTR' from the built-in .lrtemplate preset files as it would not load/execute file
+  local LocalPresetFile = loadstring(string.gsub(strPreset,'ZSTR',''))  --Loads into a function which is later called
+  if LocalPresetFile == nil then return nil end
+  local env = {}
+  setfenv(LocalPresetFile, env) --preset assigns 's' in env rather than in globals
+  LocalPresetFile() --Execute the loaded file string as lua code.  This will give access to the variable 's'
+  local settings = (env.s and env.s['value']) or {}
+  --Map and scale once, so applying is only setValue calls
+  local values = {}
+  for param, MappedParam in pairs(localPresetMap) do
+    if MappedParam ~= '' then --no local equivalent
+      local value = settings[param]
+      if value == nil then value=0; end
+      if MappedParam == 'local_Exposure' then
+        value = value * 4
+      else
+        value = value * 100
+      end
+      values[MappedParam] = value
+    end
+  end
+  LocalPresets[LocalPresetFilename] = { modified = modified, values = values }
+  return values
+end
+
 local function ApplyLocalPreset(LocalPresetFilename)  --LocalPresetName eg: 'Burn (Darken).lrtemplate'
-  local LocalPresetName = LrPathUtils.removeExtension(LrPathUtils.leafName(LocalPresetFilename))
   if LrApplicationView.getCurrentModuleName() == 'develop' and LrDevelopController.getSelectedTool() == 'masking' then
     if LocalPresetFilename == '' or LocalPresetFilename == nil then
       return
     end
-    if not LrFileUtils.exists(LocalPresetFilename) then
+    local LocalPresetName = LrPathUtils.removeExtension(LrPathUtils.leafName(LocalPresetFilename))
+    local values = LoadLocalPreset(LocalPresetFilename)
+    if values == nil then
       LrDialogs:message(LOC("$$$/AgCameraRawNamedSettings/CameraRawSettingMapping/SettingsString/ConstructionWithColon=^1: ^2",LOC("$$$/AgImageIO/Errors/FileNotFound=File not found"),LocalPresetName),'warning')
       return
     end
-    --Check to see if preset is already loaded by checking table...if so do not reload file.
-    --Reloading template file on each request would however allow the user to update and save local preset settings in lightroom.
-    if LocalPresets[tostring(LocalPresetName)] == nil then
-      local f = io.open(LocalPresetFilename)
-      local strPreset = f:read("*a")
-      f:close()
-
-      --I had to remove 'ZSTR' from the built-in .lrtemplate preset files as it would not load/execute file
-      local LocalPresetFile = loadstring(string.gsub(strPreset,'ZSTR',''))  --Loads into a function which is later called
-      LocalPresetFile() --Execute the loaded file string as lua code.  This will give access to the variable 's'
-
-      LocalPresets[tostring(LocalPresetName)] = s['value'] --Add the currently selected preset to the table of presets
-    end
     if ProgramPreferences.ClientShowBezelOnChange then
       LrDialogs.showBezel (LocalPresetName)
     end
     --Apply preset to LR
-    for param, MappedParam in pairs(localPresetMap) do
-      local value = LocalPresets[LocalPresetName][param]
-      if value == nil then value=0; end
-      if MappedParam == 'local_Exposure' then
-        value = value * 4
-      else
-        value = value * 100
-      end
+    for MappedParam, value in pairs(values) do
       MIDI2LR.PARAM_OBSERVER[MappedParam] = value
       LrDevelopController.setValue(MappedParam, value)
     end
@@ -22,6 +22,11 @@ local LrPathUtils    = import 'LrPathUtils'
 local LrShell        = import 'LrShell'
 local Ut             = require 'Utilities'
 
+-- add the app's lock contention report, if profiled, to the log being shown
+if MIDI2LR and MIDI2LR.SERVER and MIDI2LR.SERVER.send then
+  MIDI2LR.SERVER:send('LockReport 1\n')
+end
+
 local logfile = LrPathUtils.child(Ut.applogpath(), 'MIDI2LR.log')
 if LrFileUtils.exists(logfile) then
   LrShell.revealInShell(logfile)
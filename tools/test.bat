@@ -0,0 +1,13 @@
+REM Builds Debug MIDI2LR with the unit tests and allocation counting, then runs the tests.
+REM Needs the VS developer command prompt, like compile.bat. Exits non-zero if the build or any
+REM test fails; test results are written to the MIDI2LR log in %AppData%\MIDI2LR.
+SETLOCAL ENABLEEXTENSIONS ENABLEDELAYEDEXPANSION
+IF DEFINED VSINSTALLDIR (
+SET CL=/DMIDI2LR_TESTS /DMIDI2LR_COUNT_ALLOCATIONS
+msbuild ..\build\Windows\MIDI2LR_App.vcxproj /p:configuration=Debug /p:platform=x64 || EXIT /B 1
+START /WAIT "" ..\build\Windows\x64\Debug\App\MIDI2LR.exe --run-tests
+EXIT /B !ERRORLEVEL!
+) ELSE (
+echo Not in Visual Studio developer command prompt, tests will not be built.
+EXIT /B 1
+)
\ No newline at end of file
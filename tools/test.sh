@@ -0,0 +1,8 @@
+#!/bin/bash
+# Builds Debug MIDI2LR with the unit tests and allocation counting, then runs the tests. Exits
+# non-zero if the build or any test fails. Results are printed and also written to the log.
+set -e
+/usr/bin/xcodebuild -configuration Debug -project ../build/MacOS/MIDI2LR.xcodeproj \
+  CODE_SIGN_IDENTITY="" CODE_SIGNING_REQUIRED=NO \
+  GCC_PREPROCESSOR_DEFINITIONS_NOT_USED_IN_PRECOMPS="MIDI2LR_TESTS=1 MIDI2LR_COUNT_ALLOCATIONS=1"
+../build/MacOS/build/Debug/MIDI2LR.app/Contents/MacOS/MIDI2LR --run-tests
@@ -1,95 +1,34 @@
 #!/bin/bash
+# Writes one catalog per language, AppTranslation_xx.txt, in juce::LocalisedStrings format. The
+# application loads only the catalog for the selected language from the plugin folder.
+# Saved in UTF-8 encoding codepage 65001
+#
+# See https://poeditor.com/projects/view?id=359585 for translation sources and notes
+# To help in translations, sign up at https://poeditor.com/join/project?hash=v6U0MvufAn
+# Using Microsoft language portal to review the translations: https://www.microsoft.com/en-us/language/
+# For authorization for events instructions, used Apple Translation Resources, UniversalAccessPref.lg, Position: instructions.content.events
 dos2unix *.strings
-echo '/* Saved in UTF-8 encoding codepage 65001
- *
- * See https://poeditor.com/projects/view?id=359585 for translation sources and notes
- * To help in translations, sign up at https://poeditor.com/join/project?hash=v6U0MvufAn
- * Using Microsoft language portal to review the translations: https://www.microsoft.com/en-us/language/
- * For authorization for events instructions, used Apple Translation Resources, UniversalAccessPref.lg, Position: instructions.content.events
- *
- */
-namespace rsj
-{
-   const auto de = u8R"===(language: German
-countries: de at li
-' > Translate.txt
-./remove_comments.sh MIDI2LR_German.strings | sed -e '/^$/d' -e 's/";/"/' >> Translate.txt
-echo ')===";
-   const auto es = u8R"===(language: Spanish
-countries: es ar cl co cr cu do ec sv gt hn mx ni pa py pe uy ve
-' >> Translate.txt
-./remove_comments.sh MIDI2LR_Spanish.strings | sed -e '/^$/d' -e 's/";/"/' >> Translate.txt
-echo ')===";
-   const auto fr = u8R"===(language: French
-countries: fr bj bf cf cg cd ga gn ci ml mc ne sn tg ht bi mg
-' >> Translate.txt
-./remove_comments.sh MIDI2LR_French.strings | sed -e '/^$/d' -e 's/";/"/' >> Translate.txt
-echo ')===";
-   const auto it = u8R"===(language: Italian
-countries: it mt sm va
-' >> Translate.txt
-./remove_comments.sh MIDI2LR_Italian.strings | sed -e '/^$/d' -e 's/";/"/' >> Translate.txt
-echo ')===";
-   const auto hi = u8R"===(language: Hindi
-countries: in
-' >> Translate.txt
-./remove_comments.sh MIDI2LR_Hindi.strings | sed -e '/^$/d' -e 's/";/"/' >> Translate.txt
-echo ')===";
-   const auto ja = u8R"===(language: Japanese
-countries: jp
-' >> Translate.txt
-./remove_comments.sh MIDI2LR_Japanese.strings | sed -e '/^$/d' -e 's/";/"/' >> Translate.txt
-echo ')===";
-   const auto ko = u8R"===(language: Korean
-countries: kr kp
-' >> Translate.txt
-./remove_comments.sh MIDI2LR_Korean.strings | sed -e '/^$/d' -e 's/";/"/' >> Translate.txt
-echo ')===";
-   const auto nl = u8R"===(language: Dutch
-countries: nl sr
-' >> Translate.txt
-./remove_comments.sh MIDI2LR_Dutch.strings | sed -e '/^$/d' -e 's/";/"/' >> Translate.txt
-echo ')===";
-   const auto nb = u8R"===(language: Norwegian
-countries: no
-' >> Translate.txt
-./remove_comments.sh MIDI2LR_Norwegian_Bokm_l.strings | sed -e '/^$/d' -e 's/";/"/' >> Translate.txt
-echo ')===";
-   const auto pl = u8R"===(language: Polish
-countries: pl
-' >> Translate.txt
-./remove_comments.sh MIDI2LR_Polish.strings | sed -e '/^$/d' -e 's/";/"/' >> Translate.txt
-echo ')===";
-   const auto pt = u8R"===(language: Portuguese
-countries: pt br ao mz cv gw st
-' >> Translate.txt
-./remove_comments.sh MIDI2LR_Portuguese_BR.strings | sed -e '/^$/d' -e 's/";/"/' >> Translate.txt
-echo ')===";
-   const auto ru = u8R"===(language: Russian
-countries: ru
-' >> Translate.txt
-./remove_comments.sh MIDI2LR_Russian.strings | sed -e '/^$/d' -e 's/";/"/' >> Translate.txt
-echo ')===";
-   const auto sv = u8R"===(language: Swedish
-countries: se
-' >> Translate.txt
-./remove_comments.sh MIDI2LR_Swedish.strings | sed -e '/^$/d' -e 's/";/"/' >> Translate.txt
-echo ')===";
-   const auto th = u8R"===(language: Thai
-countries: th
-' >> Translate.txt
-./remove_comments.sh MIDI2LR_Thai.strings | sed -e '/^$/d' -e 's/";/"/' >> Translate.txt
-echo ')===";
-   const auto zh_cn = u8R"===(language: Chinese simplified
-countries: cn sg
-' >> Translate.txt
-./remove_comments.sh MIDI2LR_Chinese_simplified.strings | sed -e '/^$/d' -e 's/";/"/' >> Translate.txt
-echo ')===";
-   const auto zh_tw = u8R"===(language: Chinese traditional
-countries: tw
-' >> Translate.txt
-./remove_comments.sh MIDI2LR_Chinese_TW.strings | sed -e '/^$/d' -e 's/";/"/' >> Translate.txt
-echo ')===";
-} // namespace rsj' >> Translate.txt
 
-unix2dos -m Translate.txt
\ No newline at end of file
+# apptrans code language countries source
+apptrans() {
+   printf 'language: %s\ncountries: %s\n\n' "$2" "$3" > "AppTranslation_$1.txt"
+   ./remove_comments.sh "$4" | sed -e '/^$/d' -e 's/";/"/' >> "AppTranslation_$1.txt"
+   unix2dos -m "AppTranslation_$1.txt"
+}
+
+apptrans de "German" "de at li" MIDI2LR_German.strings
+apptrans es "Spanish" "es ar cl co cr cu do ec sv gt hn mx ni pa py pe uy ve" MIDI2LR_Spanish.strings
+apptrans fr "French" "fr bj bf cf cg cd ga gn ci ml mc ne sn tg ht bi mg" MIDI2LR_French.strings
+apptrans it "Italian" "it mt sm va" MIDI2LR_Italian.strings
+apptrans hi "Hindi" "in" MIDI2LR_Hindi.strings
+apptrans ja "Japanese" "jp" MIDI2LR_Japanese.strings
+apptrans ko "Korean" "kr kp" MIDI2LR_Korean.strings
+apptrans nl "Dutch" "nl sr" MIDI2LR_Dutch.strings
+apptrans nb "Norwegian" "no" MIDI2LR_Norwegian_Bokm_l.strings
+apptrans pl "Polish" "pl" MIDI2LR_Polish.strings
+apptrans pt "Portuguese" "pt br ao mz cv gw st" MIDI2LR_Portuguese_BR.strings
+apptrans ru "Russian" "ru" MIDI2LR_Russian.strings
+apptrans sv "Swedish" "se" MIDI2LR_Swedish.strings
+apptrans th "Thai" "th" MIDI2LR_Thai.strings
+apptrans zh_cn "Chinese simplified" "cn sg" MIDI2LR_Chinese_simplified.strings
+apptrans zh_tw "Chinese traditional" "tw" MIDI2LR_Chinese_TW.strings